@@ -1,3 +1,84 @@
+#pragma once
+
+#include "Patterns.h"
+
+#include "hammock/impl/compact_splay.hpp"
+#include "hammock/impl/persistent_splay.hpp"
+#include "hammock/impl/splay.hpp"
+#include "hammock/utils/pool.hpp"
+
 #include <benchmark/benchmark.h>
 
-// TODO: Implement test actors
+#include <map>
+
+namespace hammock::bench {
+using StdMap = std::map<int, int>;
+using Splay = impl::SplayTree<int, int>;
+using TopDownSplay =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, policy::TopDown>;
+using CompactSplay = impl::CompactSplayTree<int, int>;
+using PersistentSplay = impl::PersistentSplayTree<int, int>;
+template <class SplayPolicy>
+using PolicySplay =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, SplayPolicy>;
+using PoolSplay = impl::SplayTree<int, int, std::less<int>,
+                                  utils::PoolAllocator<std::pair<int, int>>>;
+using OrderedSplay =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, policy::BottomUp,
+                    policy::OrderStatistics>;
+using SumSplay =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, policy::BottomUp,
+                    policy::Aggregate<policy::Sum<long long>>>;
+using LazySplay =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, policy::BottomUp,
+                    policy::Lazy<policy::Add<int>>>;
+
+/// @brief Sizes of containers every benchmark is run for: 1K to 10M.
+inline void sizes(benchmark::internal::Benchmark *Benchmark) {
+  Benchmark->RangeMultiplier(10)->Range(1'000, 10'000'000);
+  Benchmark->Unit(benchmark::kNanosecond);
+}
+
+/// @brief Populate the given container with the keys from the given sequence.
+template <class Container>
+void populate(Container &ToPopulate, const std::vector<int> &Keys) {
+  for (int Key : Keys) {
+    ToPopulate.insert({Key, Key});
+  }
+}
+
+/// @brief Build a container of the given size with the shape produced by
+/// inserting keys according to the given pattern.
+template <class Container, Pattern Kind>
+Container build(std::size_t NumberOfElements) {
+  Container Result;
+  populate(Result, insertionOrder(Kind, NumberOfElements));
+  return Result;
+}
+} // end namespace hammock::bench
+
+// Register one benchmark template for all of the access patterns.
+#define HAMMOCK_BENCHMARK_PATTERNS(Function, Container)                        \
+  BENCHMARK_TEMPLATE(Function, Container,                                      \
+                     hammock::bench::Pattern::Sequential)                      \
+      ->Apply(hammock::bench::sizes);                                          \
+  BENCHMARK_TEMPLATE(Function, Container, hammock::bench::Pattern::Random)     \
+      ->Apply(hammock::bench::sizes);                                          \
+  BENCHMARK_TEMPLATE(Function, Container, hammock::bench::Pattern::Zipfian)    \
+      ->Apply(hammock::bench::sizes);                                          \
+  BENCHMARK_TEMPLATE(Function, Container,                                      \
+                     hammock::bench::Pattern::WorkingSet)                      \
+      ->Apply(hammock::bench::sizes)
+
+// Register one benchmark template for the baseline and all the trees.
+#define HAMMOCK_BENCHMARK(Function)                                            \
+  HAMMOCK_BENCHMARK_PATTERNS(Function, hammock::bench::StdMap);                \
+  HAMMOCK_BENCHMARK_PATTERNS(Function, hammock::bench::Splay);                 \
+  HAMMOCK_BENCHMARK_PATTERNS(Function, hammock::bench::TopDownSplay);          \
+  HAMMOCK_BENCHMARK_PATTERNS(Function, hammock::bench::CompactSplay);          \
+  HAMMOCK_BENCHMARK_PATTERNS(Function, hammock::bench::PoolSplay)
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace hammock::bench {
+
+/// @brief Access patterns used to generate keys for benchmarks.
+enum class Pattern {
+  /// Keys are accessed in the increasing order.
+  Sequential,
+  /// Keys are accessed uniformly at random.
+  Random,
+  /// Keys are accessed according to a Zipfian distribution (theta = 0.99),
+  /// i.e. a small number of keys receives the majority of accesses.
+  Zipfian,
+  /// 90% of accesses hit a small (1% of all keys) set of keys, which
+  /// slowly migrates over time; the rest is uniformly random.
+  WorkingSet
+};
+
+/// @brief Generate the order in which keys should be inserted/erased.
+///
+/// @param Kind  The access pattern to follow.
+/// @param NumberOfKeys  The number of keys in the container.
+///
+/// @return  A permutation of [0, NumberOfKeys) that follows the given
+///          access pattern.  For skewed patterns, keys appear in the order
+///          of their first access, the keys that never got accessed are
+///          appended in random order.
+std::vector<int> insertionOrder(Pattern Kind, std::size_t NumberOfKeys);
+
+/// @brief Generate a stream of accesses to the container.
+///
+/// @param Kind  The access pattern to follow.
+/// @param NumberOfKeys  The number of keys in the container, all the keys
+///                      from the stream are from [0, NumberOfKeys).
+/// @param Length  The length of the stream.
+///
+/// @return  A sequence of keys, which can contain duplicates.
+std::vector<int> accessStream(Pattern Kind, std::size_t NumberOfKeys,
+                              std::size_t Length);
+
+} // end namespace hammock::bench
@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+
+#include "hammock/impl/concurrent_splay.hpp"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+
+using namespace hammock::bench;
+
+namespace {
+using ConcurrentSplay = hammock::impl::ConcurrentSplayTree<int, int>;
+
+/// The baseline: a splay tree behind one mutex, every read splays.
+class LockedSplay {
+public:
+  std::optional<int> find(int Key) {
+    std::lock_guard Lock(Mutex);
+    auto It = Tree.find(Key);
+    return It == Tree.end() ? std::nullopt : std::optional{It->second};
+  }
+
+  bool insert(std::pair<int, int> ToInsert) {
+    std::lock_guard Lock(Mutex);
+    return Tree.insert(ToInsert).second;
+  }
+
+private:
+  TopDownSplay Tree;
+  std::mutex Mutex;
+};
+
+// Length of the access stream, it should be a power of two.
+constexpr std::size_t StreamLength = 1 << 20;
+
+// All of the benchmark threads share one container.
+template <class Container> std::unique_ptr<Container> Shared;
+
+template <class Container> void setUp(const benchmark::State &State) {
+  Shared<Container> = std::make_unique<Container>();
+  for (int Key : insertionOrder(Pattern::Random, State.range(0))) {
+    Shared<Container>->insert({Key, Key});
+  }
+}
+
+template <class Container> void tearDown(const benchmark::State &) {
+  Shared<Container>.reset();
+}
+} // end anonymous namespace
+
+template <class Container, Pattern Kind>
+static void BM_ConcurrentFind(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+  auto &Tree = *Shared<Container>;
+
+  // Threads start at different places of the same stream
+  std::size_t Index = State.thread_index() * (StreamLength / 64);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Tree.find(Stream[Index++ & (StreamLength - 1)]));
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+
+#define HAMMOCK_CONCURRENT_BENCHMARK(Container, Kind)                          \
+  BENCHMARK_TEMPLATE(BM_ConcurrentFind, Container, Kind)                       \
+      ->Setup(setUp<Container>)                                                \
+      ->Teardown(tearDown<Container>)                                          \
+      ->Arg(1'000'000)                                                         \
+      ->ThreadRange(1, 32)                                                     \
+      ->UseRealTime()
+
+HAMMOCK_CONCURRENT_BENCHMARK(LockedSplay, Pattern::Random);
+HAMMOCK_CONCURRENT_BENCHMARK(LockedSplay, Pattern::Zipfian);
+HAMMOCK_CONCURRENT_BENCHMARK(ConcurrentSplay, Pattern::Random);
+HAMMOCK_CONCURRENT_BENCHMARK(ConcurrentSplay, Pattern::Zipfian);
@@ -0,0 +1,61 @@
+#include "Benchmark.h"
+
+#include <optional>
+#include <type_traits>
+
+using namespace hammock::bench;
+
+template <class Container, Pattern Kind>
+static void BM_Copy(benchmark::State &State) {
+  const auto Tree = build<Container, Kind>(State.range(0));
+
+  for (auto _ : State) {
+    std::optional<Container> Copy{Tree};
+    benchmark::DoNotOptimize(Copy->size());
+    // We are not interested in the destruction here
+    State.PauseTiming();
+    Copy.reset();
+    State.ResumeTiming();
+  }
+
+  State.SetItemsProcessed(State.iterations() * Tree.size());
+}
+HAMMOCK_BENCHMARK(BM_Copy);
+
+template <class Container, class = void>
+struct HasSnapshotType : std::false_type {};
+
+template <class Container>
+struct HasSnapshotType<
+    Container, std::void_t<decltype(std::declval<Container &>().snapshot())>>
+    : std::true_type {};
+
+// A reporting cycle: take a consistent view of the container and keep
+// working with the live one while the view is alive.
+template <class Container, Pattern Kind>
+static void BM_SnapshotAndAccess(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  auto Tree = build<Container, Kind>(NumberOfKeys);
+  constexpr std::size_t AccessesPerSnapshot = 64;
+  const auto Stream = accessStream(Kind, NumberOfKeys, 1024);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    auto View = [&Tree] {
+      if constexpr (HasSnapshotType<Container>::value) {
+        return Tree.snapshot();
+      } else {
+        return Container{Tree};
+      }
+    }();
+    for (std::size_t i = 0; i < AccessesPerSnapshot; ++i) {
+      benchmark::DoNotOptimize(Tree.find(Stream[Index++ % Stream.size()]));
+    }
+    benchmark::DoNotOptimize(View.size());
+  }
+
+  State.SetItemsProcessed(State.iterations() * AccessesPerSnapshot);
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_SnapshotAndAccess, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_SnapshotAndAccess,
+                           hammock::bench::PersistentSplay);
@@ -0,0 +1,137 @@
+#include "Benchmark.h"
+
+#include <optional>
+
+using namespace hammock::bench;
+
+template <class Container, Pattern Kind>
+static void BM_Erase(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  const auto Keys = insertionOrder(Kind, NumberOfKeys);
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+    State.ResumeTiming();
+
+    for (int Key : Keys) {
+      Tree.erase(Tree.find(Key));
+    }
+  }
+
+  State.SetItemsProcessed(State.iterations() * NumberOfKeys);
+}
+HAMMOCK_BENCHMARK(BM_Erase);
+
+template <class Container, Pattern Kind>
+static void BM_Clear(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    auto Tree = build<Container, Kind>(NumberOfKeys);
+    State.ResumeTiming();
+
+    Tree.clear();
+    benchmark::ClobberMemory();
+  }
+
+  State.SetItemsProcessed(State.iterations() * NumberOfKeys);
+}
+HAMMOCK_BENCHMARK(BM_Clear);
+
+template <class Container, Pattern Kind>
+static void BM_Churn(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  const auto Stream = accessStream(Kind, NumberOfKeys, 1 << 16);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+
+  // Every step removes a key and puts it back, the size stays the same
+  for (auto _ : State) {
+    for (int Key : Stream) {
+      Tree.erase(Tree.find(Key));
+      Tree.insert({Key, Key});
+    }
+  }
+
+  State.SetItemsProcessed(State.iterations() * Stream.size());
+}
+HAMMOCK_BENCHMARK(BM_Churn);
+
+template <class Container, Pattern Kind>
+static void BM_EraseKey(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  const auto Keys = insertionOrder(Kind, NumberOfKeys);
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+    State.ResumeTiming();
+
+    for (int Key : Keys) {
+      Tree.erase(Key);
+    }
+  }
+
+  State.SetItemsProcessed(State.iterations() * NumberOfKeys);
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_EraseKey, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_EraseKey, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_EraseKey, hammock::bench::TopDownSplay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_EraseKey, hammock::bench::PoolSplay);
+
+// Expiry of the oldest keys: a window of them goes out of the tree and the
+// same number of new keys comes in, the size stays the same.
+template <class Container, Pattern Kind, class ExpireFunction>
+static void expireWindows(benchmark::State &State, ExpireFunction Expire) {
+  constexpr int WindowSize = 1'000;
+  const int NumberOfKeys = State.range(0);
+  auto Tree = build<Container, Pattern::Sequential>(NumberOfKeys);
+
+  int Oldest = 0;
+  for (auto _ : State) {
+    Expire(Tree, Oldest, Oldest + WindowSize);
+    State.PauseTiming();
+    for (int Key = Oldest; Key < Oldest + WindowSize; ++Key) {
+      Tree.insert({Key + NumberOfKeys, Key});
+    }
+    Oldest += WindowSize;
+    State.ResumeTiming();
+  }
+
+  State.SetItemsProcessed(State.iterations() * WindowSize);
+}
+
+template <class Container, Pattern Kind>
+static void BM_ExpireLoop(benchmark::State &State) {
+  expireWindows<Container, Kind>(
+      State, [](Container &Tree, int Lower, int Upper) {
+        for (auto It = Tree.lower_bound(Lower); It != Tree.end() and
+                                                It->first < Upper;) {
+          It = Tree.erase(It);
+        }
+      });
+}
+BENCHMARK_TEMPLATE(BM_ExpireLoop, hammock::bench::StdMap,
+                   hammock::bench::Pattern::Sequential)
+    ->Apply(hammock::bench::sizes);
+BENCHMARK_TEMPLATE(BM_ExpireLoop, hammock::bench::Splay,
+                   hammock::bench::Pattern::Sequential)
+    ->Apply(hammock::bench::sizes);
+
+template <class Container, Pattern Kind>
+static void BM_ExpireRange(benchmark::State &State) {
+  expireWindows<Container, Kind>(
+      State, [](Container &Tree, int Lower, int Upper) {
+        Tree.erase(Tree.lower_bound(Lower), Tree.lower_bound(Upper));
+      });
+}
+BENCHMARK_TEMPLATE(BM_ExpireRange, hammock::bench::StdMap,
+                   hammock::bench::Pattern::Sequential)
+    ->Apply(hammock::bench::sizes);
+BENCHMARK_TEMPLATE(BM_ExpireRange, hammock::bench::Splay,
+                   hammock::bench::Pattern::Sequential)
+    ->Apply(hammock::bench::sizes);
+BENCHMARK_TEMPLATE(BM_ExpireRange, hammock::bench::PoolSplay,
+                   hammock::bench::Pattern::Sequential)
+    ->Apply(hammock::bench::sizes);
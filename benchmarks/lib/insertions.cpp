@@ -1,21 +1,204 @@
 #include "Benchmark.h"
 
-#include "hammock/impl/splay.hpp"
+#include <algorithm>
+#include <optional>
 
-using namespace hammock::impl;
+using namespace hammock::bench;
 
-// TODO: remove placeholder benchmarks and replace them with real ones
-static void BM_StringCreation(benchmark::State& state) {
-  for (auto _ : state)
-    std::string empty_string;
+template <class Container, Pattern Kind, class InsertFunction>
+static void insertAll(benchmark::State &State, InsertFunction Insert) {
+  const auto Keys = insertionOrder(Kind, State.range(0));
+
+  for (auto _ : State) {
+    std::optional<Container> Tree{std::in_place};
+    for (int Key : Keys) {
+      benchmark::DoNotOptimize(Insert(*Tree, Key));
+    }
+    // We are not interested in the destruction here
+    State.PauseTiming();
+    Tree.reset();
+    State.ResumeTiming();
+  }
+
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <class Container, Pattern Kind>
+static void BM_Insert(benchmark::State &State) {
+  insertAll<Container, Kind>(State, [](Container &Tree, int Key) {
+    return Tree.insert({Key, Key});
+  });
+}
+HAMMOCK_BENCHMARK(BM_Insert);
+
+template <class Container, Pattern Kind>
+static void BM_Emplace(benchmark::State &State) {
+  insertAll<Container, Kind>(
+      State, [](Container &Tree, int Key) { return Tree.emplace(Key, Key); });
+}
+HAMMOCK_BENCHMARK(BM_Emplace);
+
+template <class Container, Pattern Kind>
+static void BM_TryEmplace(benchmark::State &State) {
+  insertAll<Container, Kind>(State, [](Container &Tree, int Key) {
+    return Tree.try_emplace(Key, Key);
+  });
+}
+HAMMOCK_BENCHMARK(BM_TryEmplace);
+
+// Every insertion is hinted with end(): exact for sequential keys, and
+// wrong for the others.
+template <class Container, Pattern Kind>
+static void BM_InsertHint(benchmark::State &State) {
+  insertAll<Container, Kind>(State, [](Container &Tree, int Key) {
+    return Tree.insert(Tree.end(), {Key, Key});
+  });
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_InsertHint, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_InsertHint, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_InsertHint, hammock::bench::TopDownSplay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_InsertHint, hammock::bench::PoolSplay);
+
+// Ingestion into a frozen tree, which is not splayed on the way.
+template <class Container, Pattern Kind>
+static void BM_InsertHintFrozen(benchmark::State &State) {
+  insertAll<Container, Kind>(State, [](Container &Tree, int Key) {
+    Tree.freeze();
+    return Tree.insert(Tree.end(), {Key, Key});
+  });
+}
+BENCHMARK_TEMPLATE(BM_InsertHintFrozen, hammock::bench::Splay,
+                   hammock::bench::Pattern::Sequential)
+    ->Apply(hammock::bench::sizes);
+
+// The same ingestion in the descending order, hinted with begin().
+template <class Container, Pattern Kind>
+static void BM_PrependHintFrozen(benchmark::State &State) {
+  insertAll<Container, Kind>(State, [](Container &Tree, int Key) {
+    Tree.freeze();
+    return Tree.insert(Tree.begin(), {-Key, Key});
+  });
+}
+BENCHMARK_TEMPLATE(BM_PrependHintFrozen, hammock::bench::Splay,
+                   hammock::bench::Pattern::Sequential)
+    ->Apply(hammock::bench::sizes);
+
+// Construction out of the whole range at once, only sequential keys come
+// sorted.
+template <class Container, Pattern Kind>
+static void BM_RangeConstruct(benchmark::State &State) {
+  const auto Keys = insertionOrder(Kind, State.range(0));
+  std::vector<std::pair<int, int>> Pairs;
+  for (int Key : Keys) {
+    Pairs.emplace_back(Key, Key);
+  }
+
+  for (auto _ : State) {
+    std::optional<Container> Tree{std::in_place, Pairs.begin(), Pairs.end()};
+    benchmark::DoNotOptimize(Tree->size());
+    State.PauseTiming();
+    Tree.reset();
+    State.ResumeTiming();
+  }
+
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeConstruct, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeConstruct, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeConstruct, hammock::bench::PoolSplay);
+
+// Batches of new keys go into the tree and then out of it, so that the tree
+// keeps its size.  Keys of a batch fall in between the keys of the tree.
+template <class Container, Pattern Kind, class ChurnFunction>
+static void churnBatches(benchmark::State &State, ChurnFunction Churn) {
+  constexpr std::size_t BatchSize = 10'000;
+  const std::size_t NumberOfKeys = State.range(0);
+
+  Container Tree;
+  for (int Key : insertionOrder(Pattern::Random, NumberOfKeys)) {
+    Tree.insert({2 * Key, Key});
+  }
+
+  auto Keys = insertionOrder(Kind, NumberOfKeys);
+  Keys.resize(std::min(BatchSize, Keys.size()));
+  std::vector<std::pair<int, int>> Batch;
+  for (int &Key : Keys) {
+    Key = 2 * Key + 1;
+    Batch.emplace_back(Key, Key);
+  }
+
+  for (auto _ : State) {
+    Churn(Tree, Batch, Keys);
+  }
+
+  State.SetItemsProcessed(State.iterations() * Batch.size());
+}
+
+template <class Container, Pattern Kind>
+static void BM_ChurnLoop(benchmark::State &State) {
+  churnBatches<Container, Kind>(
+      State, [](Container &Tree, const auto &Batch, const auto &Keys) {
+        for (const auto &Pair : Batch) {
+          Tree.insert(Pair);
+        }
+        for (int Key : Keys) {
+          Tree.erase(Tree.find(Key));
+        }
+      });
+}
+HAMMOCK_BENCHMARK(BM_ChurnLoop);
+
+template <class Container, Pattern Kind>
+static void BM_ChurnBatch(benchmark::State &State) {
+  churnBatches<Container, Kind>(
+      State, [](Container &Tree, const auto &Batch, const auto &Keys) {
+        Tree.insert(Batch.begin(), Batch.end());
+        Tree.erase_keys(Keys.begin(), Keys.end());
+      });
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_ChurnBatch, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_ChurnBatch, hammock::bench::PoolSplay);
+
+// Entries move from one shard to the other one by one, and back once all of
+// them are there.  Shards share the allocator.
+template <class Container, Pattern Kind, class MoveFunction>
+static void moveBetweenShards(benchmark::State &State, MoveFunction Move) {
+  const auto Keys = insertionOrder(Kind, State.range(0));
+  auto Source = build<Container, Kind>(Keys.size());
+  Container Target(std::less<int>{}, Source.get_allocator());
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    Move(Source, Target, Keys[Index]);
+    if (++Index == Keys.size()) {
+      Index = 0;
+      std::swap(Source, Target);
+    }
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+
+template <class Container, Pattern Kind>
+static void BM_MoveByValue(benchmark::State &State) {
+  moveBetweenShards<Container, Kind>(
+      State, [](Container &Source, Container &Target, int Key) {
+        auto It = Source.find(Key);
+        Target.insert({Key, It->second});
+        Source.erase(It);
+      });
 }
-// Register the function as a benchmark
-BENCHMARK(BM_StringCreation);
+HAMMOCK_BENCHMARK_PATTERNS(BM_MoveByValue, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_MoveByValue, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_MoveByValue, hammock::bench::PoolSplay);
 
-// Define another benchmark
-static void BM_StringCopy(benchmark::State& state) {
-  std::string x = "hello";
-  for (auto _ : state)
-    std::string copy(x);
+template <class Container, Pattern Kind>
+static void BM_MoveNode(benchmark::State &State) {
+  moveBetweenShards<Container, Kind>(
+      State, [](Container &Source, Container &Target, int Key) {
+        Target.insert(Source.extract(Key));
+      });
 }
-BENCHMARK(BM_StringCopy);
+HAMMOCK_BENCHMARK_PATTERNS(BM_MoveNode, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_MoveNode, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_MoveNode, hammock::bench::PoolSplay);
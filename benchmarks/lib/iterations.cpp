@@ -0,0 +1,82 @@
+#include "Benchmark.h"
+
+#include <vector>
+
+using namespace hammock::bench;
+
+template <class Container, Pattern Kind, class IteratorType>
+static void iterate(benchmark::State &State, const Container &Tree,
+                    IteratorType Begin, IteratorType End) {
+  for (auto _ : State) {
+    long Sum = 0;
+    for (auto It = Begin; It != End; ++It) {
+      Sum += It->second;
+    }
+    benchmark::DoNotOptimize(Sum);
+  }
+
+  State.SetItemsProcessed(State.iterations() * Tree.size());
+}
+
+template <class Container, Pattern Kind>
+static void BM_InOrder(benchmark::State &State) {
+  // The shape of the tree is determined by the order of insertions
+  const auto Tree = build<Container, Kind>(State.range(0));
+  iterate<Container, Kind>(State, Tree, Tree.begin(), Tree.end());
+}
+HAMMOCK_BENCHMARK(BM_InOrder);
+
+// std::map has no pre-order and post-order traversals, that's why
+// there is no baseline for the following benchmarks.
+
+template <class Container, Pattern Kind>
+static void BM_PreOrder(benchmark::State &State) {
+  const auto Tree = build<Container, Kind>(State.range(0));
+  iterate<Container, Kind>(State, Tree, Tree.pre_begin(), Tree.pre_end());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_PreOrder, hammock::bench::Splay);
+
+template <class Container, Pattern Kind>
+static void BM_PostOrder(benchmark::State &State) {
+  const auto Tree = build<Container, Kind>(State.range(0));
+  iterate<Container, Kind>(State, Tree, Tree.post_begin(), Tree.post_end());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_PostOrder, hammock::bench::Splay);
+
+// Bulk scans without iterators, they don't go back up the tree.
+
+template <class Container, Pattern Kind>
+static void BM_ForEach(benchmark::State &State) {
+  const auto Tree = build<Container, Kind>(State.range(0));
+  for (auto _ : State) {
+    long Sum = 0;
+    Tree.for_each([&Sum](const auto &Pair) { Sum += Pair.second; });
+    benchmark::DoNotOptimize(Sum);
+  }
+
+  State.SetItemsProcessed(State.iterations() * Tree.size());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_ForEach, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_ForEach, hammock::bench::PoolSplay);
+
+// An export job reading the tree in chunks of pointers.
+template <class Container, Pattern Kind>
+static void BM_Gather(benchmark::State &State) {
+  constexpr std::size_t ChunkSize = 256;
+  const auto Tree = build<Container, Kind>(State.range(0));
+  std::vector<const typename Container::KeyValuePairType *> Buffer(ChunkSize);
+  for (auto _ : State) {
+    long Sum = 0;
+    auto From = Tree.begin();
+    while (std::size_t Count =
+               Tree.gather(From, Tree.end(), Buffer.data(), ChunkSize)) {
+      for (std::size_t i = 0; i < Count; ++i) {
+        Sum += Buffer[i]->second;
+      }
+    }
+    benchmark::DoNotOptimize(Sum);
+  }
+
+  State.SetItemsProcessed(State.iterations() * Tree.size());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_Gather, hammock::bench::Splay);
@@ -0,0 +1,228 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+
+using namespace hammock::bench;
+
+// Length of the access stream, it should be a power of two.
+static constexpr std::size_t StreamLength = 1 << 20;
+
+template <class Container, Pattern Kind>
+static void BM_Find(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  // The shape of the tree should not depend on the access pattern
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Tree.find(Stream[Index++ & (StreamLength - 1)]));
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+HAMMOCK_BENCHMARK(BM_Find);
+
+// Negative lookups: the tree has only even keys and the stream asks for
+// the odd ones.
+template <class Container, Pattern Kind>
+static void BM_FindMissing(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  Container Tree;
+  for (int Key : insertionOrder(Pattern::Random, NumberOfKeys)) {
+    Tree.insert({Key * 2, Key});
+  }
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(
+        Tree.find(Stream[Index++ & (StreamLength - 1)] * 2 + 1));
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+HAMMOCK_BENCHMARK(BM_FindMissing);
+
+// Splay trees built from sequential insertions are degenerate: all the nodes
+// form one long path.  It shows the cost of the first passes through very
+// deep trees before splaying brings them back into shape.
+//
+// Cache misses can be collected with --benchmark_perf_counters=CACHE-MISSES.
+template <class Container, Pattern Kind>
+static void BM_FindDeep(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::optional<Container> Tree{
+        build<Container, Pattern::Sequential>(NumberOfKeys)};
+    State.ResumeTiming();
+
+    for (std::size_t Index = 0; Index < NumberOfKeys; ++Index) {
+      benchmark::DoNotOptimize(Tree->find(Stream[Index & (StreamLength - 1)]));
+    }
+
+    State.PauseTiming();
+    Tree.reset();
+    State.ResumeTiming();
+  }
+
+  State.SetItemsProcessed(State.iterations() * NumberOfKeys);
+}
+HAMMOCK_BENCHMARK(BM_FindDeep);
+
+// Short range scans: find the lower bound and walk a few elements from it.
+template <class Container, Pattern Kind>
+static void BM_RangeScan(benchmark::State &State) {
+  constexpr int ScanLength = 16;
+  const std::size_t NumberOfKeys = State.range(0);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    auto It = Tree.lower_bound(Stream[Index++ & (StreamLength - 1)]);
+    int Sum = 0;
+    for (int i = 0; i < ScanLength and It != Tree.end(); ++i, ++It) {
+      Sum += It->second;
+    }
+    benchmark::DoNotOptimize(Sum);
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeScan, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeScan, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeScan, hammock::bench::TopDownSplay);
+
+// Batches of lookups: one find() after another vs find_batch.
+static constexpr std::size_t BatchSize = 256;
+
+template <class Container, Pattern Kind>
+static void BM_FindLoop(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+  std::vector<typename Container::iterator> Results(BatchSize);
+
+  std::size_t Offset = 0;
+  for (auto _ : State) {
+    auto First = Stream.begin() + Offset;
+    std::transform(First, First + BatchSize, Results.begin(),
+                   [&Tree](int Key) { return Tree.find(Key); });
+    benchmark::DoNotOptimize(Results.data());
+    Offset = (Offset + BatchSize) & (StreamLength - 1);
+  }
+
+  State.SetItemsProcessed(State.iterations() * BatchSize);
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_FindLoop, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_FindLoop, hammock::bench::TopDownSplay);
+
+template <class Container, Pattern Kind>
+static void BM_FindBatch(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+  std::vector<typename Container::iterator> Results(BatchSize);
+
+  std::size_t Offset = 0;
+  for (auto _ : State) {
+    auto First = Stream.begin() + Offset;
+    Tree.find_batch(First, First + BatchSize, Results.begin());
+    benchmark::DoNotOptimize(Results.data());
+    Offset = (Offset + BatchSize) & (StreamLength - 1);
+  }
+
+  State.SetItemsProcessed(State.iterations() * BatchSize);
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_FindBatch, hammock::bench::Splay);
+HAMMOCK_BENCHMARK_PATTERNS(BM_FindBatch, hammock::bench::TopDownSplay);
+
+// Keys of the built trees are exactly their positions in the sorted order.
+// Without sizes of sub-trees, finding the element by its position is
+// a linear walk.
+template <class Container, Pattern Kind>
+static void BM_Select(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    const int Position = Stream[Index];
+    if constexpr (std::is_same_v<Container, StdMap>) {
+      benchmark::DoNotOptimize(std::next(Tree.begin(), Position));
+    } else {
+      benchmark::DoNotOptimize(Tree.select(Position));
+    }
+    Index = (Index + 1) & (StreamLength - 1);
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_Select, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_Select, hammock::bench::OrderedSplay);
+
+// Sums of values over windows of keys, every window has about a percent
+// of all keys.
+template <class Container, Pattern Kind>
+static void BM_RangeSum(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  const int Width = std::max<int>(1, NumberOfKeys / 100);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    const int Lower = Stream[Index], Upper = Lower + Width;
+    if constexpr (std::is_same_v<Container, StdMap>) {
+      long long Sum = 0;
+      for (auto It = Tree.lower_bound(Lower);
+           It != Tree.end() and It->first < Upper; ++It) {
+        Sum += It->second;
+      }
+      benchmark::DoNotOptimize(Sum);
+    } else {
+      benchmark::DoNotOptimize(Tree.aggregate(Lower, Upper));
+    }
+    Index = (Index + 1) & (StreamLength - 1);
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeSum, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeSum, hammock::bench::SumSplay);
+
+// Shifts of values over windows of keys, every window has about a percent
+// of all keys.
+template <class Container, Pattern Kind>
+static void BM_RangeAdd(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  const int Width = std::max<int>(1, NumberOfKeys / 100);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    const int Lower = Stream[Index], Upper = Lower + Width;
+    if constexpr (std::is_same_v<Container, StdMap>) {
+      for (auto It = Tree.lower_bound(Lower);
+           It != Tree.end() and It->first < Upper; ++It) {
+        ++It->second;
+      }
+    } else {
+      Tree.update_range(Lower, Upper, 1);
+    }
+    Index = (Index + 1) & (StreamLength - 1);
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeAdd, hammock::bench::StdMap);
+HAMMOCK_BENCHMARK_PATTERNS(BM_RangeAdd, hammock::bench::LazySplay);
@@ -0,0 +1,46 @@
+#include "Benchmark.h"
+
+#include <optional>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace hammock::bench;
+
+namespace {
+/// Bytes of the heap currently in use by the process.
+std::size_t heapInUse() {
+#ifdef __GLIBC__
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+} // end anonymous namespace
+
+// Measure how much memory the container takes per element.
+//
+// We measure the heap usage instead of the resident set size because the
+// latter depends on what malloc decided to do with memory freed by previous
+// benchmarks.  For a freshly started process, the growth of RSS is the same.
+template <class Container, Pattern Kind>
+static void BM_Memory(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  double HeapPerElement = 0;
+
+  for (auto _ : State) {
+    const auto HeapBefore = heapInUse();
+
+    std::optional<Container> Tree{build<Container, Kind>(NumberOfKeys)};
+
+    HeapPerElement = double(heapInUse() - HeapBefore) / NumberOfKeys;
+
+    State.PauseTiming();
+    Tree.reset();
+    State.ResumeTiming();
+  }
+
+  State.counters["HeapBytes/element"] = HeapPerElement;
+}
+HAMMOCK_BENCHMARK(BM_Memory);
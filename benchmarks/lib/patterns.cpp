@@ -0,0 +1,183 @@
+#include "Patterns.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace hammock::bench {
+namespace {
+
+using Engine = std::mt19937_64;
+constexpr Engine::result_type Seed = 0x5eed;
+
+std::vector<int> identity(std::size_t NumberOfKeys) {
+  std::vector<int> Result(NumberOfKeys);
+  std::iota(Result.begin(), Result.end(), 0);
+  return Result;
+}
+
+std::vector<int> shuffled(std::size_t NumberOfKeys, Engine &Random) {
+  auto Result = identity(NumberOfKeys);
+  std::shuffle(Result.begin(), Result.end(), Random);
+  return Result;
+}
+
+/// Zipfian generator from "Quickly Generating Billion-Record Synthetic
+/// Databases" by Gray et al. (the one used by YCSB).
+///
+/// It generates ranks in [0, NumberOfKeys), where rank 0 is the most popular.
+class ZipfianGenerator {
+public:
+  explicit ZipfianGenerator(std::size_t NumberOfKeys, double Theta = 0.99)
+      : NumberOfKeys(NumberOfKeys), Theta(Theta), Alpha(1.0 / (1.0 - Theta)),
+        ZetaN(zeta(NumberOfKeys, Theta)) {
+    const double Zeta2 = zeta(2, Theta);
+    Eta = (1.0 - std::pow(2.0 / NumberOfKeys, 1.0 - Theta)) /
+          (1.0 - Zeta2 / ZetaN);
+  }
+
+  std::size_t operator()(Engine &Random) {
+    const double U = std::uniform_real_distribution<double>{}(Random);
+    const double UZ = U * ZetaN;
+
+    if (UZ < 1.0)
+      return 0;
+
+    if (UZ < 1.0 + std::pow(0.5, Theta))
+      return 1;
+
+    const auto Rank = static_cast<std::size_t>(
+        NumberOfKeys * std::pow(Eta * U - Eta + 1.0, Alpha));
+    return std::min(Rank, NumberOfKeys - 1);
+  }
+
+private:
+  static double zeta(std::size_t N, double Theta) {
+    double Sum = 0;
+    for (std::size_t I = 1; I <= N; ++I) {
+      Sum += 1.0 / std::pow(static_cast<double>(I), Theta);
+    }
+    return Sum;
+  }
+
+  std::size_t NumberOfKeys;
+  double Theta, Alpha, ZetaN, Eta;
+};
+
+/// Working set generator: 90% of accesses go to a window of 1% of keys,
+/// which is moved to a new random place every WindowLifetime accesses.
+class WorkingSetGenerator {
+public:
+  explicit WorkingSetGenerator(std::size_t NumberOfKeys)
+      : NumberOfKeys(NumberOfKeys),
+        WindowSize(std::max<std::size_t>(1, NumberOfKeys / 100)) {}
+
+  std::size_t operator()(Engine &Random) {
+    if (Accesses++ % WindowLifetime == 0) {
+      WindowStart = std::uniform_int_distribution<std::size_t>{
+          0, NumberOfKeys - WindowSize}(Random);
+    }
+
+    if (std::uniform_int_distribution<unsigned>{0, 9}(Random) != 0) {
+      return WindowStart + std::uniform_int_distribution<std::size_t>{
+                               0, WindowSize - 1}(Random);
+    }
+
+    return std::uniform_int_distribution<std::size_t>{0, NumberOfKeys - 1}(
+        Random);
+  }
+
+private:
+  static constexpr std::size_t WindowLifetime = 1 << 16;
+
+  std::size_t NumberOfKeys, WindowSize;
+  std::size_t WindowStart = 0, Accesses = 0;
+};
+
+/// Draw Length ranks from the Generator and map them to keys.
+///
+/// Ranks are scrambled, so that hot keys are scattered all over the key
+/// space instead of being the smallest ones.
+template <class Generator>
+std::vector<int> draw(Generator Next, std::size_t NumberOfKeys,
+                      std::size_t Length, Engine &Random) {
+  const auto Scramble = shuffled(NumberOfKeys, Random);
+  std::vector<int> Result(Length);
+  for (auto &Key : Result) {
+    Key = Scramble[Next(Random)];
+  }
+  return Result;
+}
+
+/// Keep only first occurrences of keys and append the missing ones.
+std::vector<int> firstOccurrences(const std::vector<int> &Stream,
+                                  std::size_t NumberOfKeys, Engine &Random) {
+  std::vector<bool> Seen(NumberOfKeys, false);
+  std::vector<int> Result;
+  Result.reserve(NumberOfKeys);
+
+  for (int Key : Stream) {
+    if (not Seen[Key]) {
+      Seen[Key] = true;
+      Result.push_back(Key);
+    }
+  }
+
+  const auto Accessed = Result.size();
+  for (std::size_t Key = 0; Key < NumberOfKeys; ++Key) {
+    if (not Seen[Key]) {
+      Result.push_back(Key);
+    }
+  }
+  std::shuffle(Result.begin() + Accessed, Result.end(), Random);
+  return Result;
+}
+
+} // end anonymous namespace
+
+std::vector<int> insertionOrder(Pattern Kind, std::size_t NumberOfKeys) {
+  Engine Random{Seed};
+
+  switch (Kind) {
+  case Pattern::Sequential:
+    return identity(NumberOfKeys);
+  case Pattern::Random:
+    return shuffled(NumberOfKeys, Random);
+  case Pattern::Zipfian:
+  case Pattern::WorkingSet:
+    return firstOccurrences(accessStream(Kind, NumberOfKeys, NumberOfKeys),
+                            NumberOfKeys, Random);
+  }
+  return {};
+}
+
+std::vector<int> accessStream(Pattern Kind, std::size_t NumberOfKeys,
+                              std::size_t Length) {
+  Engine Random{Seed + 1};
+
+  switch (Kind) {
+  case Pattern::Sequential: {
+    std::vector<int> Result(Length);
+    for (std::size_t I = 0; I < Length; ++I) {
+      Result[I] = I % NumberOfKeys;
+    }
+    return Result;
+  }
+  case Pattern::Random:
+    return draw(
+        [NumberOfKeys](Engine &Random) {
+          return std::uniform_int_distribution<std::size_t>{
+              0, NumberOfKeys - 1}(Random);
+        },
+        NumberOfKeys, Length, Random);
+  case Pattern::Zipfian:
+    return draw(ZipfianGenerator{NumberOfKeys}, NumberOfKeys, Length, Random);
+  case Pattern::WorkingSet:
+    return draw(WorkingSetGenerator{NumberOfKeys}, NumberOfKeys, Length,
+                Random);
+  }
+  return {};
+}
+
+} // end namespace hammock::bench
@@ -0,0 +1,29 @@
+#include "Benchmark.h"
+
+using namespace hammock::bench;
+using namespace hammock::policy;
+
+// Length of the access stream, it should be a power of two.
+static constexpr std::size_t StreamLength = 1 << 20;
+
+// Lookups with different splaying policies, policies are configured with
+// their default parameters.
+template <class Container, Pattern Kind>
+static void BM_PolicyFind(benchmark::State &State) {
+  const std::size_t NumberOfKeys = State.range(0);
+  auto Tree = build<Container, Pattern::Random>(NumberOfKeys);
+  const auto Stream = accessStream(Kind, NumberOfKeys, StreamLength);
+
+  std::size_t Index = 0;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Tree.find(Stream[Index++ & (StreamLength - 1)]));
+  }
+
+  State.SetItemsProcessed(State.iterations());
+}
+HAMMOCK_BENCHMARK_PATTERNS(BM_PolicyFind, PolicySplay<BottomUp>);
+HAMMOCK_BENCHMARK_PATTERNS(BM_PolicyFind, PolicySplay<TopDown>);
+HAMMOCK_BENCHMARK_PATTERNS(BM_PolicyFind, PolicySplay<Probabilistic>);
+HAMMOCK_BENCHMARK_PATTERNS(BM_PolicyFind, PolicySplay<SemiSplay>);
+HAMMOCK_BENCHMARK_PATTERNS(BM_PolicyFind, PolicySplay<DepthThreshold>);
+HAMMOCK_BENCHMARK_PATTERNS(BM_PolicyFind, PolicySplay<Counter>);
@@ -0,0 +1,335 @@
+#pragma once
+
+#include "hammock/utils/inserter.hpp"
+#include "hammock/utils/iterator.hpp"
+#include "hammock/utils/node.hpp"
+#include "hammock/utils/rotation.hpp"
+#include "hammock/utils/transform.hpp"
+#include "hammock/utils/type_traits.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hammock::impl {
+/// @brief Splay tree with nodes that have no parent pointers.
+///
+/// Every node costs two pointers on top of the key-value pair.  The tree is
+/// always splayed top-down, and its iterators keep the path from the root to
+/// the current node.
+///
+/// @note  Unlike SplayTree, every operation that splays the tree (find,
+///        insert, erase) invalidates all of the iterators.
+template <class KeyType, class ValueType, class Compare = std::less<KeyType>,
+          class AllocatorType = std::allocator<std::pair<KeyType, ValueType>>>
+class CompactSplayTree {
+public:
+  using Node = utils::CompactNode<KeyType, ValueType>;
+  using KeyValuePairType = typename Node::Pair;
+  using NodeAllocatorType = typename std::allocator_traits<
+      AllocatorType>::template rebind_alloc<Node>;
+  using AllocatorTraits = std::allocator_traits<NodeAllocatorType>;
+
+  using iterator = utils::StackIterator<CompactSplayTree>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_iterator = utils::StackIterator<CompactSplayTree, true>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  using allocator_type = AllocatorType;
+
+  static_assert(
+      std::is_invocable_v<const Compare &, const KeyType &, const KeyType &>,
+      "comparison object must be invocable as const");
+
+  CompactSplayTree(std::initializer_list<KeyValuePairType> Initializer) {
+    for (auto &Pair : Initializer) {
+      insert(Pair);
+    }
+  }
+
+  constexpr CompactSplayTree() noexcept = default;
+
+  CompactSplayTree(CompactSplayTree &&Origin) noexcept
+      : Root{std::exchange(Origin.Root, nullptr)},
+        Size{std::exchange(Origin.Size, 0)}, Comparator{Origin.Comparator},
+        Allocator{Origin.Allocator} {}
+
+  CompactSplayTree(const CompactSplayTree &Origin)
+      : Size{Origin.Size}, Comparator{Origin.Comparator},
+        Allocator{AllocatorTraits::select_on_container_copy_construction(
+            Origin.Allocator)} {
+    copyTree(Origin.Root, Origin.Size);
+  }
+
+  CompactSplayTree &operator=(const CompactSplayTree &Origin) {
+    if (this != &Origin) {
+      clear();
+      Comparator = Origin.Comparator;
+      if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::
+                        value) {
+        Allocator = Origin.Allocator;
+      }
+      copyTree(Origin.Root, Origin.Size);
+      Size = Origin.Size;
+    }
+    return *this;
+  }
+
+  CompactSplayTree &operator=(CompactSplayTree &&Origin) noexcept(
+      AllocatorTraits::propagate_on_container_move_assignment::value ||
+      AllocatorTraits::is_always_equal::value) {
+    if (this == &Origin) {
+      return *this;
+    }
+
+    clear();
+    Comparator = Origin.Comparator;
+    if constexpr (AllocatorTraits::propagate_on_container_move_assignment::
+                      value) {
+      Allocator = Origin.Allocator;
+    } else if (Allocator != Origin.Allocator) {
+      // nodes can't change their allocator, move them one by one
+      for (auto &Pair : Origin) {
+        insert(std::move(Pair));
+      }
+      Origin.clear();
+      return *this;
+    }
+    Root = std::exchange(Origin.Root, nullptr);
+    Size = std::exchange(Origin.Size, 0);
+    return *this;
+  }
+
+  ~CompactSplayTree() noexcept { clear(); }
+
+  std::pair<iterator, bool> insert(const KeyValuePairType &ValueToInsert) {
+    return insertImpl(utils::Inserter{
+        [&ValueToInsert]() -> auto & { return ValueToInsert.first; },
+        [&ValueToInsert, this]() { return create(ValueToInsert); }});
+  }
+
+  std::pair<iterator, bool> insert(KeyValuePairType &&ValueToInsert) {
+    return insertImpl(utils::Inserter{
+        [&ValueToInsert]() -> auto & { return ValueToInsert.first; },
+        [&ValueToInsert, this]() { return create(std::move(ValueToInsert)); }});
+  }
+
+  template <class... ConstructorTypes>
+  std::pair<iterator, bool>
+  emplace(ConstructorTypes &&... ConstructorArguments) {
+    // The key is known only after the node is created
+    auto *NewNode =
+        create(std::forward<ConstructorTypes>(ConstructorArguments)...);
+    auto Result = insertImpl(
+        utils::Inserter{[NewNode]() -> auto & { return NewNode->Key(); },
+                        [NewNode]() { return NewNode; }});
+    if (not Result.second) {
+      destruct(NewNode);
+    }
+    return Result;
+  }
+
+  template <class... ConstructorTypes>
+  std::pair<iterator, bool>
+  try_emplace(const KeyType &Key, ConstructorTypes &&... ConstructorArguments) {
+    return insertImpl(utils::Inserter{
+        [&Key]() -> auto & { return Key; },
+        [&Key, &ConstructorArguments..., this]() {
+          return create(std::piecewise_construct, std::forward_as_tuple(Key),
+                        std::forward_as_tuple(std::forward<ConstructorTypes>(
+                            ConstructorArguments)...));
+        }});
+  }
+
+  iterator erase(iterator ToErase) {
+    if (ToErase == end())
+      return ToErase;
+
+    // Bring the node to the top and join its sub-trees after that
+    auto *NodeToErase = splay(ToErase->first);
+    assert(("Splaying should find the node" &&
+            NodeToErase == ToErase.getNode()));
+
+    const bool HasLeft = NodeToErase->Left != nullptr;
+    Root = NodeToErase->Right;
+    if (HasLeft) {
+      // Every key in the left sub-tree is less than the key of the erased
+      // node, splaying it by this key brings its maximum to the top.
+      Root = utils::splayTopDown(NodeToErase->Left, NodeToErase->Key(),
+                                 Comparator);
+      Root->Right = NodeToErase->Right;
+    }
+
+    destruct(NodeToErase);
+    --Size;
+
+    // The successor is the leftmost node of the right sub-tree of the erased
+    // node, which is either the whole tree or the right sub-tree of the root.
+    typename iterator::Path Ancestors;
+    auto *Current = Root;
+    if (HasLeft) {
+      if (Root->Right == nullptr)
+        return end();
+      Ancestors.push_back(Root);
+      Current = Root->Right;
+    }
+    for (; Current != nullptr; Current = Current->Left) {
+      Ancestors.push_back(Current);
+    }
+    return {&Root, std::move(Ancestors)};
+  }
+
+  void clear() noexcept {
+    // Nothing to destroy, and if the allocator has nothing but our nodes,
+    // all of its memory can go at once.
+    bool Released = false;
+    if constexpr (utils::CanReleaseAtOnce<NodeAllocatorType> and
+                  std::is_trivially_destructible_v<KeyValuePairType>) {
+      if (Allocator.allocated() == Size) {
+        Allocator.release();
+        Released = true;
+      }
+    }
+    if (not Released) {
+      utils::destroyTree(Root,
+                         [this](Node *ToDestroy) { destruct(ToDestroy); });
+    }
+    Root = nullptr;
+    Size = 0;
+  }
+
+  bool contains(const KeyType &Key) { return find(Key) != end(); }
+
+  std::size_t count(const KeyType &Key) { return contains(Key); }
+
+  ValueType &at(const KeyType &Key) {
+    auto It = find(Key);
+    if (It == end()) {
+      throw std::out_of_range("CompactSplayTree::at");
+    }
+    return It->second;
+  }
+
+  iterator find(const KeyType &Key) {
+    if (Root != nullptr and isEquivalent(splay(Key)->Key(), Key)) {
+      return {&Root, {Root}};
+    }
+    return end();
+  }
+
+  iterator begin() { return first<iterator, utils::Direction::Left>(); }
+  iterator end() { return {&Root}; }
+  const_iterator begin() const {
+    return first<const_iterator, utils::Direction::Left>();
+  }
+  const_iterator end() const { return {&Root}; }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  std::size_t size() const { return Size; }
+  bool empty() const { return Size == 0; }
+
+private:
+  template <class InserterType>
+  std::pair<iterator, bool> insertImpl(InserterType Inserter) {
+    if (Root == nullptr) {
+      Root = Inserter.getNode();
+
+    } else {
+      // After splaying, the root is either the node with the same key,
+      // or its future neighbor.
+      splay(Inserter.getKey());
+      if (isEquivalent(Root->Key(), Inserter.getKey()))
+        return {{&Root, {Root}}, false};
+
+      auto *Inserted = Inserter.getNode();
+      // The new node becomes the root and the old root goes to the side
+      if (Comparator(Inserter.getKey(), Root->Key())) {
+        Inserted->Left = std::exchange(Root->Left, nullptr);
+        Inserted->Right = Root;
+      } else {
+        Inserted->Right = std::exchange(Root->Right, nullptr);
+        Inserted->Left = Root;
+      }
+      Root = Inserted;
+    }
+
+    ++Size;
+    return {{&Root, {Root}}, true};
+  }
+
+  Node *splay(const KeyType &Key) {
+    return Root = utils::splayTopDown(Root, Key, Comparator);
+  }
+
+  template <class IteratorType, utils::Direction To>
+  IteratorType first() const {
+    typename IteratorType::Path Ancestors;
+    for (auto *Current = Root; Current != nullptr;
+         Current = utils::getChild<To>(Current)) {
+      Ancestors.push_back(Current);
+    }
+    return {&Root, std::move(Ancestors)};
+  }
+
+  void copyTree(const Node *Origin, std::size_t Count) {
+    if (Origin == nullptr) {
+      Root = nullptr;
+      return;
+    }
+    if constexpr (utils::CanReserve<NodeAllocatorType>) {
+      // Copies are created in pre-order, see SplayTree::copyTree
+      Allocator.reserve(Count);
+    }
+
+    // Pairs of original nodes and places to put their copies into
+    std::vector<std::pair<const Node *, Node **>> ToCopy{{Origin, &Root}};
+    while (not ToCopy.empty()) {
+      auto [Original, Location] = ToCopy.back();
+      ToCopy.pop_back();
+
+      auto *Copy = *Location = create(Original->KeyValuePair());
+      if (Original->Right)
+        ToCopy.emplace_back(Original->Right, &Copy->Right);
+      if (Original->Left)
+        ToCopy.emplace_back(Original->Left, &Copy->Left);
+    }
+  }
+
+  bool isEquivalent(const KeyType &LHS, const KeyType &RHS) const {
+    return not Comparator(LHS, RHS) and not Comparator(RHS, LHS);
+  }
+
+  template <class... ArgsTypes>
+  [[nodiscard]] Node *create(ArgsTypes &&... Args) {
+    auto *DataChunk =
+        std::allocator_traits<NodeAllocatorType>::allocate(Allocator, 1);
+    ::new (DataChunk) Node;
+    std::allocator_traits<NodeAllocatorType>::construct(
+        Allocator, DataChunk->Pointer(), std::forward<ArgsTypes>(Args)...);
+    return DataChunk;
+  }
+
+  void destruct(Node *ToDealloc) {
+    std::allocator_traits<NodeAllocatorType>::destroy(Allocator,
+                                                      ToDealloc->Pointer());
+    std::allocator_traits<NodeAllocatorType>::deallocate(Allocator, ToDealloc,
+                                                         1);
+  }
+
+  Node *Root = nullptr;
+  std::size_t Size = 0;
+  Compare Comparator{};
+  NodeAllocatorType Allocator{};
+};
+
+} // end namespace hammock::impl
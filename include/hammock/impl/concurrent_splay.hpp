@@ -0,0 +1,173 @@
+#pragma once
+
+#include "hammock/impl/splay.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace hammock::impl {
+/// @brief Thread-safe wrapper around SplayTree.
+///
+/// Reads search the tree under a shared lock without restructuring it, so
+/// readers don't serialize on each other.  Only a sample of reads splays the
+/// tree afterwards, and only if the exclusive lock is free at that moment.
+/// This way hot keys still drift towards the root, but readers never wait
+/// for each other because of splaying.
+///
+/// Every write takes the exclusive lock, so writes are better grouped into
+/// batches, which are applied under one lock acquisition.
+///
+/// @note  Values are returned by copy, references into the tree would not
+///        survive concurrent modifications.
+template <class KeyType, class ValueType, class Compare = std::less<KeyType>,
+          class AllocatorType = std::allocator<std::pair<KeyType, ValueType>>,
+          class SplayPolicy = policy::TopDown>
+class ConcurrentSplayTree {
+public:
+  using Tree =
+      SplayTree<KeyType, ValueType, Compare, AllocatorType, SplayPolicy>;
+  using KeyValuePairType = std::pair<KeyType, ValueType>;
+
+  /// @brief Group of writes applied at once.
+  class Batch {
+  public:
+    void insert(KeyValuePairType ToInsert) {
+      Operations.emplace_back(std::move(ToInsert));
+    }
+    void erase(KeyType ToErase) { Operations.emplace_back(std::move(ToErase)); }
+
+    std::size_t size() const { return Operations.size(); }
+    bool empty() const { return Operations.empty(); }
+
+  private:
+    friend class ConcurrentSplayTree;
+    std::vector<std::variant<KeyValuePairType, KeyType>> Operations;
+  };
+
+  /// @param SplayPeriod  One in about @p SplayPeriod reads tries to splay the
+  ///                     tree.  Zero turns splaying on reads off.
+  explicit ConcurrentSplayTree(unsigned SplayPeriod = 16)
+      : SplayPeriod(SplayPeriod) {}
+
+  ConcurrentSplayTree(const ConcurrentSplayTree &) = delete;
+  ConcurrentSplayTree &operator=(const ConcurrentSplayTree &) = delete;
+
+  std::optional<ValueType> find(const KeyType &Key) const {
+    std::optional<ValueType> Result;
+    {
+      std::shared_lock Lock(Mutex);
+      if (auto It = reader().find(Key); It != reader().end()) {
+        Result = It->second;
+      }
+    }
+    maybeSplay(Key);
+    return Result;
+  }
+
+  bool contains(const KeyType &Key) const {
+    bool Result;
+    {
+      std::shared_lock Lock(Mutex);
+      Result = reader().contains(Key);
+    }
+    maybeSplay(Key);
+    return Result;
+  }
+
+  /// @brief Call @p Visitor with the value of the given key under the shared
+  /// lock.
+  ///
+  /// @return  True if the key was found.
+  template <class VisitorType>
+  bool visit(const KeyType &Key, VisitorType Visitor) const {
+    bool Found = false;
+    {
+      std::shared_lock Lock(Mutex);
+      if (auto It = reader().find(Key); It != reader().end()) {
+        std::invoke(Visitor, std::as_const(It->second));
+        Found = true;
+      }
+    }
+    maybeSplay(Key);
+    return Found;
+  }
+
+  bool insert(KeyValuePairType ToInsert) {
+    std::unique_lock Lock(Mutex);
+    return Impl.insert(std::move(ToInsert)).second;
+  }
+
+  bool erase(const KeyType &Key) {
+    std::unique_lock Lock(Mutex);
+    return Impl.erase(Key) != 0;
+  }
+
+  /// @brief Apply all of the writes from the batch in their order under one
+  /// exclusive lock.
+  void apply(Batch &&Writes) {
+    std::unique_lock Lock(Mutex);
+    for (auto &Operation : Writes.Operations) {
+      if (auto *ToInsert = std::get_if<KeyValuePairType>(&Operation)) {
+        Impl.insert(std::move(*ToInsert));
+      } else {
+        Impl.erase(std::get<KeyType>(Operation));
+      }
+    }
+    Writes.Operations.clear();
+  }
+
+  void clear() {
+    std::unique_lock Lock(Mutex);
+    Impl.clear();
+  }
+
+  std::size_t size() const {
+    std::shared_lock Lock(Mutex);
+    return Impl.size();
+  }
+
+  bool empty() const { return size() == 0; }
+
+private:
+  /// Readers go only through the const interface, which doesn't splay.
+  const Tree &reader() const { return Impl; }
+
+  void maybeSplay(const KeyType &Key) const {
+    if (SplayPeriod == 0 or nextRandom() % SplayPeriod != 0) {
+      return;
+    }
+    // Somebody is busy with the tree, it is not worth waiting
+    std::unique_lock Lock(Mutex, std::try_to_lock);
+    if (Lock.owns_lock()) {
+      Impl.find(Key);
+    }
+  }
+
+  /// Cheap per-thread pseudo-random numbers (xorshift32).
+  static std::uint32_t nextRandom() {
+    // The state of xorshift should never be zero
+    thread_local std::uint32_t State =
+        static_cast<std::uint32_t>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id())) |
+        1;
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    return State;
+  }
+
+  // Splaying on reads doesn't change the contents of the tree
+  mutable Tree Impl;
+  mutable std::shared_mutex Mutex;
+  unsigned SplayPeriod;
+};
+
+} // end namespace hammock::impl
@@ -0,0 +1,423 @@
+#pragma once
+
+#include "hammock/utils/inserter.hpp"
+#include "hammock/utils/iterator.hpp"
+#include "hammock/utils/node.hpp"
+#include "hammock/utils/rotation.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace hammock::impl {
+/// @brief Splay tree that hands out read-only snapshots of itself in
+/// constant time.
+///
+/// Nodes have no parent pointers and are shared between the tree and its
+/// snapshots.  Before the tree splays (which it does on every access), it
+/// copies the shared nodes on the search path, and only them: everything
+/// off the path is re-linked, but never changed.  So the cost of a snapshot
+/// is proportional to what the tree touches afterwards, and not to its size.
+///
+/// Snapshots can be read from other threads while the tree keeps changing.
+/// The tree itself is not thread-safe.
+///
+/// @note  Elements of the tree are immutable through its iterators, because
+///        they might be shared with snapshots.  Values can be changed with
+///        at() and insert_or_assign().
+///
+/// @note  Like with CompactSplayTree, every operation that splays the tree
+///        invalidates all of its iterators.
+///
+/// @note  Snapshots free the nodes they were the last to refer to, so the
+///        allocator should be thread-safe if snapshots are dropped on other
+///        threads.
+template <class KeyType, class ValueType, class Compare = std::less<KeyType>,
+          class AllocatorType = std::allocator<std::pair<KeyType, ValueType>>>
+class PersistentSplayTree {
+public:
+  using Node = utils::SharedNode<KeyType, ValueType>;
+  using KeyValuePairType = typename Node::Pair;
+  using NodeAllocatorType = typename std::allocator_traits<
+      AllocatorType>::template rebind_alloc<Node>;
+  using AllocatorTraits = std::allocator_traits<NodeAllocatorType>;
+
+  using const_iterator = utils::StackIterator<PersistentSplayTree, true>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using iterator = const_iterator;
+  using reverse_iterator = const_reverse_iterator;
+
+  using allocator_type = AllocatorType;
+
+  static_assert(
+      std::is_invocable_v<const Compare &, const KeyType &, const KeyType &>,
+      "comparison object must be invocable as const");
+
+  /// @brief Immutable view of the tree as it was at the moment of
+  /// snapshot().
+  ///
+  /// Reads don't splay, and copies of the snapshot share all of its nodes.
+  class Snapshot {
+  public:
+    /// @brief Construct the snapshot of an empty tree.
+    Snapshot() = default;
+
+    Snapshot(const Snapshot &Origin)
+        : Root{retain(Origin.Root)}, Size{Origin.Size},
+          Comparator{Origin.Comparator}, Allocator{Origin.Allocator} {}
+
+    Snapshot(Snapshot &&Origin) noexcept
+        : Root{std::exchange(Origin.Root, nullptr)},
+          Size{std::exchange(Origin.Size, 0)}, Comparator{Origin.Comparator},
+          Allocator{Origin.Allocator} {}
+
+    Snapshot &operator=(Snapshot Origin) noexcept {
+      std::swap(Root, Origin.Root);
+      std::swap(Size, Origin.Size);
+      std::swap(Comparator, Origin.Comparator);
+      std::swap(Allocator, Origin.Allocator);
+      return *this;
+    }
+
+    ~Snapshot() noexcept { release(Root, Allocator); }
+
+    const_iterator find(const KeyType &Key) const {
+      typename const_iterator::Path Ancestors;
+      for (const Node *Current = Root; Current != nullptr;) {
+        Ancestors.push_back(Current);
+        if (Comparator(Key, Current->Key())) {
+          Current = Current->Left;
+        } else if (Comparator(Current->Key(), Key)) {
+          Current = Current->Right;
+        } else {
+          return {&Root, std::move(Ancestors)};
+        }
+      }
+      return end();
+    }
+
+    bool contains(const KeyType &Key) const { return find(Key) != end(); }
+
+    std::size_t count(const KeyType &Key) const { return contains(Key); }
+
+    const ValueType &at(const KeyType &Key) const {
+      auto It = find(Key);
+      if (It == end()) {
+        throw std::out_of_range("PersistentSplayTree::Snapshot::at");
+      }
+      return It->second;
+    }
+
+    const_iterator begin() const {
+      return first<const_iterator, utils::Direction::Left>(Root);
+    }
+    const_iterator end() const { return {&Root}; }
+
+    const_reverse_iterator rbegin() const {
+      return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+      return const_reverse_iterator(begin());
+    }
+
+    std::size_t size() const { return Size; }
+    bool empty() const { return Size == 0; }
+
+  private:
+    friend class PersistentSplayTree;
+
+    Snapshot(Node *Root, std::size_t Size, const Compare &Comparator,
+             const NodeAllocatorType &Allocator)
+        : Root{retain(Root)}, Size{Size}, Comparator{Comparator},
+          Allocator{Allocator} {}
+
+    Node *Root = nullptr;
+    std::size_t Size = 0;
+    Compare Comparator{};
+    NodeAllocatorType Allocator{};
+  };
+
+  PersistentSplayTree(std::initializer_list<KeyValuePairType> Initializer) {
+    for (auto &Pair : Initializer) {
+      insert(Pair);
+    }
+  }
+
+  constexpr PersistentSplayTree() noexcept = default;
+
+  PersistentSplayTree(PersistentSplayTree &&Origin) noexcept
+      : Root{std::exchange(Origin.Root, nullptr)},
+        Size{std::exchange(Origin.Size, 0)}, Comparator{Origin.Comparator},
+        Allocator{Origin.Allocator} {}
+
+  /// @brief Copy the tree in constant time, both trees share all of the
+  /// nodes until they change.
+  ///
+  /// @note  The copy uses the same allocator as the original, shared nodes
+  ///        can be freed by either of them.
+  PersistentSplayTree(const PersistentSplayTree &Origin)
+      : Root{retain(Origin.Root)}, Size{Origin.Size},
+        Comparator{Origin.Comparator}, Allocator{Origin.Allocator} {}
+
+  PersistentSplayTree &operator=(const PersistentSplayTree &Origin) {
+    if (this != &Origin) {
+      auto *ToRelease = std::exchange(Root, retain(Origin.Root));
+      release(ToRelease, Allocator);
+      Size = Origin.Size;
+      Comparator = Origin.Comparator;
+      Allocator = Origin.Allocator;
+    }
+    return *this;
+  }
+
+  PersistentSplayTree &operator=(PersistentSplayTree &&Origin) noexcept {
+    if (this != &Origin) {
+      clear();
+      Root = std::exchange(Origin.Root, nullptr);
+      Size = std::exchange(Origin.Size, 0);
+      Comparator = Origin.Comparator;
+      Allocator = Origin.Allocator;
+    }
+    return *this;
+  }
+
+  ~PersistentSplayTree() noexcept { clear(); }
+
+  /// @brief Take a read-only snapshot of the tree in constant time.
+  Snapshot snapshot() const { return {Root, Size, Comparator, Allocator}; }
+
+  std::pair<iterator, bool> insert(const KeyValuePairType &ValueToInsert) {
+    return insertImpl(utils::Inserter{
+        [&ValueToInsert]() -> auto & { return ValueToInsert.first; },
+        [&ValueToInsert, this]() { return create(ValueToInsert); }});
+  }
+
+  std::pair<iterator, bool> insert(KeyValuePairType &&ValueToInsert) {
+    return insertImpl(utils::Inserter{
+        [&ValueToInsert]() -> auto & { return ValueToInsert.first; },
+        [&ValueToInsert, this]() { return create(std::move(ValueToInsert)); }});
+  }
+
+  template <class... ConstructorTypes>
+  std::pair<iterator, bool>
+  try_emplace(const KeyType &Key, ConstructorTypes &&... ConstructorArguments) {
+    return insertImpl(utils::Inserter{
+        [&Key]() -> auto & { return Key; },
+        [&Key, &ConstructorArguments..., this]() {
+          return create(std::piecewise_construct, std::forward_as_tuple(Key),
+                        std::forward_as_tuple(std::forward<ConstructorTypes>(
+                            ConstructorArguments)...));
+        }});
+  }
+
+  template <class MappedType>
+  std::pair<iterator, bool> insert_or_assign(const KeyType &Key,
+                                             MappedType &&Value) {
+    auto Result = try_emplace(Key, std::forward<MappedType>(Value));
+    if (not Result.second) {
+      // The root was just copied if it was shared
+      Root->Value() = std::forward<MappedType>(Value);
+    }
+    return Result;
+  }
+
+  /// @return  The number of erased elements (zero or one).
+  std::size_t erase(const KeyType &Key) {
+    if (Root == nullptr or not isEquivalent(splay(Key)->Key(), Key)) {
+      return 0;
+    }
+
+    auto *NodeToErase = Root;
+    Root = NodeToErase->Right;
+    if (NodeToErase->Left != nullptr) {
+      // Every key in the left sub-tree is less than the key of the erased
+      // node, splaying it by this key brings its maximum to the top.
+      Root = splay(NodeToErase->Left, Key);
+      Root->Right = NodeToErase->Right;
+    }
+
+    // Sub-trees of the erased node are linked to the new root already
+    NodeToErase->Left = NodeToErase->Right = nullptr;
+    release(NodeToErase, Allocator);
+    --Size;
+    return 1;
+  }
+
+  void clear() noexcept {
+    release(std::exchange(Root, nullptr), Allocator);
+    Size = 0;
+  }
+
+  bool contains(const KeyType &Key) { return find(Key) != end(); }
+
+  std::size_t count(const KeyType &Key) { return contains(Key); }
+
+  /// @note  The reference is valid until the next operation splaying the
+  ///        tree or taking its snapshot.
+  ValueType &at(const KeyType &Key) {
+    if (Root == nullptr or not isEquivalent(splay(Key)->Key(), Key)) {
+      throw std::out_of_range("PersistentSplayTree::at");
+    }
+    return Root->Value();
+  }
+
+  iterator find(const KeyType &Key) {
+    if (Root != nullptr and isEquivalent(splay(Key)->Key(), Key)) {
+      return {&Root, {Root}};
+    }
+    return end();
+  }
+
+  const_iterator begin() const {
+    return first<const_iterator, utils::Direction::Left>(Root);
+  }
+  const_iterator end() const { return {&Root}; }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  std::size_t size() const { return Size; }
+  bool empty() const { return Size == 0; }
+
+  allocator_type get_allocator() const { return allocator_type(Allocator); }
+
+private:
+  template <class InserterType>
+  std::pair<iterator, bool> insertImpl(InserterType Inserter) {
+    if (Root == nullptr) {
+      Root = Inserter.getNode();
+
+    } else {
+      // After splaying, the root is either the node with the same key,
+      // or its future neighbor.
+      splay(Inserter.getKey());
+      if (isEquivalent(Root->Key(), Inserter.getKey()))
+        return {{&Root, {Root}}, false};
+
+      auto *Inserted = Inserter.getNode();
+      // The new node becomes the root and the old root goes to the side
+      if (Comparator(Inserter.getKey(), Root->Key())) {
+        Inserted->Left = std::exchange(Root->Left, nullptr);
+        Inserted->Right = Root;
+      } else {
+        Inserted->Right = std::exchange(Root->Right, nullptr);
+        Inserted->Left = Root;
+      }
+      Root = Inserted;
+    }
+
+    ++Size;
+    return {{&Root, {Root}}, true};
+  }
+
+  Node *splay(const KeyType &Key) { return Root = splay(Root, Key); }
+
+  /// Splay the sub-tree by the given key after making the search path its
+  /// own, so that snapshots sharing the path don't see the rotations.
+  Node *splay(Node *&Top, const KeyType &Key) {
+    for (auto **Link = &Top; *Link != nullptr;) {
+      auto *Current = *Link = own(*Link);
+      if (Comparator(Key, Current->Key())) {
+        Link = &Current->Left;
+      } else if (Comparator(Current->Key(), Key)) {
+        Link = &Current->Right;
+      } else {
+        break;
+      }
+    }
+    return utils::splayTopDown(Top, Key, Comparator);
+  }
+
+  /// @brief Get the node that belongs only to this tree.
+  ///
+  /// @param Shared  The node linked from the node that belongs only to this
+  ///                tree (or from the root).
+  ///
+  /// @return  Either @p Shared itself, or its copy replacing it.
+  Node *own(Node *Shared) {
+    // Other trees can only drop their references, nobody else can add one
+    // to the node reachable only from this tree.
+    if (Shared->References.load(std::memory_order_acquire) == 1) {
+      return Shared;
+    }
+    auto *Copy = create(Shared->KeyValuePair());
+    Copy->Left = retain(Shared->Left);
+    Copy->Right = retain(Shared->Right);
+    release(Shared, Allocator);
+    return Copy;
+  }
+
+  static Node *retain(Node *ToShare) {
+    if (ToShare != nullptr) {
+      ToShare->References.fetch_add(1, std::memory_order_relaxed);
+    }
+    return ToShare;
+  }
+
+  /// Drop one reference to the sub-tree and destroy every node that nobody
+  /// refers to anymore.
+  static void release(Node *Top, NodeAllocatorType &Allocator) noexcept {
+    // Dead nodes with right sub-trees still to release are chained through
+    // their left links, nobody else sees them anyway.
+    Node *Dead = nullptr;
+    for (auto *Current = Top;;) {
+      if (Current != nullptr and
+          Current->References.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        auto *Left = std::exchange(Current->Left, Dead);
+        Dead = Current;
+        Current = Left;
+        continue;
+      }
+      if (Dead == nullptr) {
+        return;
+      }
+      Current = Dead->Right;
+      destruct(std::exchange(Dead, Dead->Left), Allocator);
+    }
+  }
+
+  template <class IteratorType, utils::Direction To>
+  static IteratorType first(Node *const &Top) {
+    typename IteratorType::Path Ancestors;
+    for (auto *Current = Top; Current != nullptr;
+         Current = utils::getChild<To>(Current)) {
+      Ancestors.push_back(Current);
+    }
+    return {&Top, std::move(Ancestors)};
+  }
+
+  bool isEquivalent(const KeyType &LHS, const KeyType &RHS) const {
+    return not Comparator(LHS, RHS) and not Comparator(RHS, LHS);
+  }
+
+  template <class... ArgsTypes>
+  [[nodiscard]] Node *create(ArgsTypes &&... Args) {
+    auto *DataChunk =
+        std::allocator_traits<NodeAllocatorType>::allocate(Allocator, 1);
+    ::new (DataChunk) Node;
+    std::allocator_traits<NodeAllocatorType>::construct(
+        Allocator, DataChunk->Pointer(), std::forward<ArgsTypes>(Args)...);
+    return DataChunk;
+  }
+
+  static void destruct(Node *ToDealloc, NodeAllocatorType &Allocator) {
+    std::allocator_traits<NodeAllocatorType>::destroy(Allocator,
+                                                      ToDealloc->Pointer());
+    ToDealloc->~Node();
+    std::allocator_traits<NodeAllocatorType>::deallocate(Allocator, ToDealloc,
+                                                         1);
+  }
+
+  Node *Root = nullptr;
+  std::size_t Size = 0;
+  Compare Comparator{};
+  NodeAllocatorType Allocator{};
+};
+
+} // end namespace hammock::impl
@@ -1,28 +1,42 @@
 #pragma once
 
+#include "hammock/policy/augmentation.hpp"
+#include "hammock/policy/splaying.hpp"
+#include "hammock/tags.hpp"
 #include "hammock/utils/inserter.hpp"
 #include "hammock/utils/iterator.hpp"
 #include "hammock/utils/node.hpp"
+#include "hammock/utils/prefetch.hpp"
 #include "hammock/utils/rotation.hpp"
 #include "hammock/utils/transform.hpp"
 #include "hammock/utils/traversal.hpp"
+#include "hammock/utils/type_traits.hpp"
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
+#include <functional>
+#include <optional>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace hammock::impl {
 template <class KeyType, class ValueType, class Compare = std::less<KeyType>,
-          class AllocatorType = std::allocator<std::pair<KeyType, ValueType>>>
+          class AllocatorType = std::allocator<std::pair<KeyType, ValueType>>,
+          class SplayPolicy = policy::BottomUp,
+          class Augmentation = policy::NoAugmentation>
 class SplayTree {
 public:
-  using Node = utils::Node<KeyType, ValueType>;
+  using Node = utils::Node<KeyType, ValueType, Augmentation>;
   using CompressedNode = typename Node::Header;
   using HeaderType = CompressedNode;
   using KeyValuePairType = typename Node::Pair;
   using NodeAllocatorType = typename std::allocator_traits<
       AllocatorType>::template rebind_alloc<Node>;
+  using AllocatorTraits = std::allocator_traits<NodeAllocatorType>;
 
   using iterator = utils::Iterator<SplayTree>;
   using reverse_iterator = std::reverse_iterator<iterator>;
@@ -45,6 +59,81 @@ public:
   using const_reverse_pre_iterator = std::reverse_iterator<const_pre_iterator>;
 
   using allocator_type = AllocatorType;
+  using splay_policy = SplayPolicy;
+  using augmentation = Augmentation;
+  using difference_type = std::ptrdiff_t;
+
+  /// @brief Owner of a node extracted from the tree.
+  ///
+  /// The node keeps its key-value pair, and inserting the handle into
+  /// a tree with an equal allocator links the node without copying it.
+  class node_type {
+  public:
+    using key_type = KeyType;
+    using mapped_type = ValueType;
+    using allocator_type = AllocatorType;
+
+    constexpr node_type() noexcept = default;
+    node_type(node_type &&Origin) noexcept
+        : Handled(std::exchange(Origin.Handled, nullptr)),
+          Allocator(std::move(Origin.Allocator)) {}
+
+    node_type &operator=(node_type &&Origin) noexcept {
+      if (this != &Origin) {
+        reset();
+        Handled = std::exchange(Origin.Handled, nullptr);
+        Allocator = std::move(Origin.Allocator);
+      }
+      return *this;
+    }
+
+    ~node_type() noexcept { reset(); }
+
+    [[nodiscard]] bool empty() const noexcept { return Handled == nullptr; }
+    explicit operator bool() const noexcept { return not empty(); }
+
+    allocator_type get_allocator() const { return allocator_type(*Allocator); }
+
+    /// @pre  The handle is not empty.
+    key_type &key() const {
+      // Nobody compares the key while the node is out of the tree
+      return const_cast<key_type &>(Handled->Key());
+    }
+
+    /// @pre  The handle is not empty.
+    mapped_type &mapped() const { return Handled->Value(); }
+
+    void swap(node_type &Other) noexcept {
+      std::swap(Handled, Other.Handled);
+      std::swap(Allocator, Other.Allocator);
+    }
+    friend void swap(node_type &LHS, node_type &RHS) noexcept {
+      LHS.swap(RHS);
+    }
+
+  private:
+    friend class SplayTree;
+
+    node_type(Node *Handled, const NodeAllocatorType &Allocator)
+        : Handled(Handled), Allocator(Allocator) {}
+
+    Node *release() { return std::exchange(Handled, nullptr); }
+
+    void reset() noexcept {
+      if (Handled != nullptr) {
+        destruct(release(), *Allocator);
+      }
+    }
+
+    Node *Handled = nullptr;
+    std::optional<NodeAllocatorType> Allocator;
+  };
+
+  struct insert_return_type {
+    iterator position;
+    bool inserted;
+    node_type node;
+  };
 
   static_assert(
       std::is_invocable_v<Compare &, const KeyType &, const KeyType &>,
@@ -54,33 +143,61 @@ public:
       std::is_invocable_v<const Compare &, const KeyType &, const KeyType &>,
       "comparison object must be invocable as const");
 
-  SplayTree(std::initializer_list<KeyValuePairType> Initializer) noexcept {
-    // TODO: it is a very-very basic version of this insertion
-    // it might need to replace existing values in order to
-    // replicate std::map's behavior
-    for (auto &Pair : Initializer) {
-      insert(Pair);
-    }
-  };
+  /// @brief Construct the tree out of the range of key-value pairs.
+  ///
+  /// Sorted ranges take linear time, others are sorted first.  If there
+  /// are equivalent keys, only the first one of them is inserted.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  SplayTree(InputIterator First, InputIterator Last) {
+    assign(First, Last);
+  }
+
+  /// @brief Construct the tree out of the sorted range in linear time.
+  ///
+  /// @pre  Keys in the range are sorted and unique.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  SplayTree(sorted_unique_t, InputIterator First, InputIterator Last) {
+    assign(sorted_unique, First, Last);
+  }
+
+  SplayTree(std::initializer_list<KeyValuePairType> Initializer)
+      : SplayTree(Initializer.begin(), Initializer.end()) {}
 
   constexpr SplayTree() noexcept = default;
 
+  /// @brief Construct an empty tree with the configured splaying policy.
+  explicit SplayTree(const SplayPolicy &Policy) : Splayer(Policy) {}
+
+  /// @brief Construct an empty tree with the given comparator and allocator.
+  explicit SplayTree(const Compare &Comparator,
+                     const AllocatorType &Allocator = AllocatorType())
+      : Comparator(Comparator), Allocator(Allocator) {}
+
+  explicit SplayTree(const AllocatorType &Allocator) : Allocator(Allocator) {}
+
   SplayTree(SplayTree &&Origin) noexcept
-      : Size{std::exchange(Origin.Size, 0)},
-        Comparator{Origin.Comparator}, Allocator{Origin.Allocator} {
+      : Size{std::exchange(Origin.Size, 0)}, Comparator{Origin.Comparator},
+        Allocator{Origin.Allocator}, Splayer{Origin.Splayer},
+        PendingUpdates{std::exchange(Origin.PendingUpdates, false)} {
     moveHeader(std::move(Origin.Header));
   }
 
   SplayTree(const SplayTree &Origin)
-      : Size{Origin.Size},
-        Comparator{Origin.Comparator}, Allocator{Origin.Allocator} {
-    copyTree(Origin.Header);
+      : Size{Origin.Size}, Comparator{Origin.Comparator},
+        Allocator{AllocatorTraits::select_on_container_copy_construction(
+            Origin.Allocator)},
+        Splayer{Origin.Splayer}, PendingUpdates{Origin.PendingUpdates} {
+    copyTree(Origin.Header, Origin.Size);
   }
 
   void moveHeader(HeaderType &&Origin) noexcept {
     Header.Parent = std::exchange(Origin.Parent, nullptr);
-    Header.Left = std::exchange(Origin.Left, nullptr);
-    Header.Right = std::exchange(Origin.Right, nullptr);
+    setShortcut<utils::Direction::Left>(
+        Origin.template getShortcut<utils::Direction::Left>());
+    setShortcut<utils::Direction::Right>(
+        Origin.template getShortcut<utils::Direction::Right>());
+    Origin.template setShortcut<utils::Direction::Left>(nullptr);
+    Origin.template setShortcut<utils::Direction::Right>(nullptr);
     if (Header.Parent != nullptr) {
       Header.Parent->Parent = &Header;
     }
@@ -91,24 +208,111 @@ public:
       // unlike the case with copy construction we might
       // actually have some data in this tree, we need to clear it
       clear();
-      copyTree(Origin.Header);
+      if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::
+                        value) {
+        Allocator = Origin.Allocator;
+      }
+      copyTree(Origin.Header, Origin.Size);
       Size = Origin.Size;
       Comparator = Origin.Comparator;
-      Allocator = Origin.Allocator;
+      Splayer = Origin.Splayer;
+      PendingUpdates = Origin.PendingUpdates;
     }
     return *this;
   }
 
-  SplayTree &operator=(SplayTree &&Origin) noexcept {
+  SplayTree &operator=(SplayTree &&Origin) noexcept(
+      AllocatorTraits::propagate_on_container_move_assignment::value ||
+      AllocatorTraits::is_always_equal::value) {
+    if (this == &Origin) {
+      return *this;
+    }
+
+    // nodes of this tree should go back to the allocator they came from
+    clear();
+    Comparator = Origin.Comparator;
+    Splayer = Origin.Splayer;
+    if constexpr (AllocatorTraits::propagate_on_container_move_assignment::
+                      value) {
+      Allocator = Origin.Allocator;
+    } else if (Allocator != Origin.Allocator) {
+      // we can't adopt nodes allocated by somebody else, so we move
+      // them element by element
+      for (auto &Pair : Origin) {
+        insert(std::move(Pair));
+      }
+      Origin.clear();
+      return *this;
+    }
     moveHeader(std::move(Origin.Header));
     Size = std::exchange(Origin.Size, 0);
-    Comparator = Origin.Comparator;
-    Allocator = Origin.Allocator;
+    PendingUpdates = std::exchange(Origin.PendingUpdates, false);
     return *this;
   }
 
   ~SplayTree() noexcept { clear(); }
 
+  /// @brief Replace the contents of the tree with the range of key-value
+  /// pairs.
+  ///
+  /// Sorted ranges take linear time, others are sorted first.  If there
+  /// are equivalent keys, only the first one of them is inserted.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  void assign(InputIterator First, InputIterator Last) {
+    using Category = utils::IteratorCategory<InputIterator>;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+      // Checking the order is cheap compared to building the tree
+      auto IsNotIncreasing = [this](const auto &LHS, const auto &RHS) {
+        return not Comparator(LHS.first, RHS.first);
+      };
+      if (std::adjacent_find(First, Last, IsNotIncreasing) == Last) {
+        assign(sorted_unique, First, Last);
+        return;
+      }
+    }
+
+    auto Sorted = sortUnique(First, Last);
+    assign(sorted_unique, std::make_move_iterator(Sorted.begin()),
+           std::make_move_iterator(Sorted.end()));
+  }
+
+
+  /// @brief Replace the contents of the tree with the sorted range of
+  /// key-value pairs in linear time.
+  ///
+  /// @pre  Keys in the range are sorted and unique.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  void assign(sorted_unique_t, InputIterator First, InputIterator Last) {
+    using Category = utils::IteratorCategory<InputIterator>;
+    if constexpr (not std::is_base_of_v<std::forward_iterator_tag, Category>) {
+      // We need to know the size of the range before building the tree
+      std::vector<std::pair<KeyType, ValueType>> Buffer(First, Last);
+      assign(sorted_unique, std::make_move_iterator(Buffer.begin()),
+             std::make_move_iterator(Buffer.end()));
+    } else {
+      clear();
+      const std::size_t Count = std::distance(First, Last);
+      if constexpr (utils::CanReserve<NodeAllocatorType>) {
+        // Nodes of the tree go one after another in memory
+        Allocator.reserve(Count);
+      }
+
+      auto Create = [this](auto &&Pair) {
+        return create(std::forward<decltype(Pair)>(Pair));
+      };
+      auto Destroy = [this](Node *ToDestroy) { destruct(ToDestroy); };
+      auto *Root = utils::buildTree<Node>(First, Count, Create, Destroy);
+
+      if (Root != nullptr) {
+        Root->Parent = &Header;
+        assignRoot(Root);
+        adjustShortcut<utils::Direction::Left>(Root);
+        adjustShortcut<utils::Direction::Right>(Root);
+      }
+      Size = Count;
+    }
+  }
+
   std::pair<iterator, bool> insert(const KeyValuePairType &ValueToInsert) {
     return insertImpl(utils::Inserter{
         [&ValueToInsert]() -> auto& { return ValueToInsert.first; },
@@ -151,68 +355,539 @@ public:
         [&Key]() ->auto& { return Key; },
         [&Key, &ConstructorArguments..., this]() {
           return create(std::piecewise_construct, std::forward_as_tuple(Key),
-                        std::forward_as_tuple(ConstructorArguments)...);
+                        std::forward_as_tuple(std::forward<ConstructorTypes>(
+                            ConstructorArguments)...));
         }
     });
   }
 
+  template <class... ConstructorTypes>
+  std::pair<iterator, bool>
+  try_emplace(KeyType &&Key, ConstructorTypes &&... ConstructorArguments) {
+    // The key is moved only after all of the comparisons are done
+    return insertImpl(utils::Inserter{
+        [&Key]() -> auto & { return Key; },
+        [&Key, &ConstructorArguments..., this]() {
+          return create(std::piecewise_construct,
+                        std::forward_as_tuple(std::move(Key)),
+                        std::forward_as_tuple(std::forward<ConstructorTypes>(
+                            ConstructorArguments)...));
+        }});
+  }
+
+  /// @brief Insert the key-value pair as close as possible to the hint.
+  ///
+  /// If the new key goes right before or right after @p Hint, the search
+  /// starts from there instead of the root.  Appends with end() as the hint
+  /// take constant amortized time, and so do prepends with begin().
+  /// A wrong hint costs a lookup of its neighbor, which can take the depth
+  /// of the tree, before the regular insertion.
+  ///
+  /// Frozen trees are not splayed after hinted insertions, and accurately
+  /// hinted insertions into them take constant time (not counting updates
+  /// of the augmentation, if any).
+  iterator insert(const_iterator Hint, const KeyValuePairType &ValueToInsert) {
+    return insertHintImpl(Hint, utils::Inserter{
+        [&ValueToInsert]() -> auto & { return ValueToInsert.first; },
+        [&ValueToInsert, this]() { return create(ValueToInsert); }}).first;
+  }
+
+  iterator insert(const_iterator Hint, KeyValuePairType &&ValueToInsert) {
+    return insertHintImpl(Hint, utils::Inserter{
+        [&ValueToInsert]() -> auto & { return ValueToInsert.first; },
+        [&ValueToInsert, this]() {
+          return create(std::move(ValueToInsert));
+        }}).first;
+  }
+
+  template <class... ConstructorTypes>
+  iterator emplace_hint(const_iterator Hint,
+                        ConstructorTypes &&... ConstructorArguments) {
+    auto *NewNode =
+        create(std::forward<ConstructorTypes>(ConstructorArguments)...);
+    auto Result = insertHintImpl(
+        Hint, utils::Inserter{[NewNode]() -> auto & { return NewNode->Key(); },
+                              [NewNode]() { return NewNode; }});
+    if (not Result.second) {
+      destruct(NewNode);
+    }
+    return Result.first;
+  }
+
+  template <class... ConstructorTypes>
+  std::pair<iterator, bool>
+  try_emplace(const_iterator Hint, const KeyType &Key,
+              ConstructorTypes &&... ConstructorArguments) {
+    return insertHintImpl(Hint, utils::Inserter{
+        [&Key]() -> auto & { return Key; },
+        [&Key, &ConstructorArguments..., this]() {
+          return create(std::piecewise_construct, std::forward_as_tuple(Key),
+                        std::forward_as_tuple(std::forward<ConstructorTypes>(
+                            ConstructorArguments)...));
+        }});
+  }
+
+  template <class... ConstructorTypes>
+  std::pair<iterator, bool>
+  try_emplace(const_iterator Hint, KeyType &&Key,
+              ConstructorTypes &&... ConstructorArguments) {
+    return insertHintImpl(Hint, utils::Inserter{
+        [&Key]() -> auto & { return Key; },
+        [&Key, &ConstructorArguments..., this]() {
+          return create(std::piecewise_construct,
+                        std::forward_as_tuple(std::move(Key)),
+                        std::forward_as_tuple(std::forward<ConstructorTypes>(
+                            ConstructorArguments)...));
+        }});
+  }
+
+  iterator erase(const_iterator ToErase) { return erase(mutableOf(ToErase)); }
+
+  /// @brief Erase all of the elements in [First, Last).
+  ///
+  /// @p First and @p Last are splayed one after another, so that the range
+  /// becomes one sub-tree, which is cut off and destroyed as a whole.
+  /// It takes O(log n + k) amortized time for k erased elements.
+  ///
+  /// @return  The iterator to Last.
+  iterator erase(const_iterator First, const_iterator Last) {
+    auto Begin = mutableOf(First), End = mutableOf(Last);
+    if (Begin == End) {
+      return End;
+    }
+    if (Begin == begin() and End == end()) {
+      clear();
+      return end();
+    }
+
+    // Everything before the range hangs on the left of its first node
+    auto *Lowest = Begin.getNode();
+    bringToRoot(Lowest);
+    utils::pushAugmentation(Lowest);
+    Node *Before = std::exchange(Lowest->Left, nullptr);
+    utils::updateAugmentation(Lowest);
+
+    // ...and the rest of the range is on the left of its end
+    Node *Erased = Lowest;
+    if (End == end()) {
+      // Something is left, otherwise it would've been cleared
+      Before->Parent = &Header;
+      assignRoot(Before);
+      adjustShortcut<utils::Direction::Right>(Before);
+    } else {
+      auto *Upper = End.getNode();
+      bringToRoot(Upper);
+      utils::pushAugmentation(Upper);
+      Erased = std::exchange(Upper->Left, Before);
+      if (Before != nullptr) {
+        Before->Parent = Upper;
+      } else {
+        setShortcut<utils::Direction::Left>(Upper);
+      }
+      utils::updateAugmentation(Upper);
+    }
+
+    std::size_t Count = 0;
+    utils::destroyTree(Erased, [this, &Count](Node *ToDestroy) {
+      destruct(ToDestroy);
+      ++Count;
+    });
+    Size -= Count;
+    return End;
+  }
+
   iterator erase(iterator ToErase) {
     if (ToErase == end())
       return ToErase;
 
     Node *NodeToErase = ToErase.getNode();
-    Node *NodeToReplace = nullptr;
-
     ++ToErase;
-    // Check if we have a right sub-tree...
-    if (NodeToErase->Right == nullptr) {
-      // ...if we don't, we can simply replace the node of
-      // interest with its left child.
-      NodeToReplace = NodeToErase->Left;
+    unlink(NodeToErase, ToErase);
+    destruct(NodeToErase);
+
+    return ToErase;
+  }
+
+  /// @brief Erase the element with the given key.
+  ///
+  /// The last node on the search path is splayed all the way to the root
+  /// with any splaying policy, and if it is the one to erase, its two
+  /// sub-trees are joined.  Unlike erase(iterator), repeated erasures keep
+  /// the tree balanced.
+  ///
+  /// @return  The number of erased elements (zero or one).
+  std::size_t erase(const KeyType &Key) {
+    if (empty()) {
+      return 0;
+    }
+    Node *Root = nullptr;
+    if constexpr (SplayPolicy::IsTopDown) {
+      Root = splayTopDown(Key);
     } else {
-      // ...otherwise the successor of our node is in the right sub-tree.
-      // We can swap the node of interest with its successor.
-      utils::swap(NodeToErase, ToErase.getNode());
-      // Successor could've had only the right child (otherwise its
-      // left child would've been a successor).
-      NodeToReplace = NodeToErase->Right;
+      Root = utils::find(getRoot(), Key, Comparator).first;
+      utils::splay(static_cast<CompressedNode *>(Root));
+    }
+    if (not isEquivalent(Root->Key(), Key)) {
+      return 0;
     }
 
-    // Even if the child doesn't exist it is still a valid replacement.
-    utils::replace(NodeToErase, NodeToReplace);
+    releaseShortcuts(Root);
+    unlinkRoot(Root);
+    destruct(Root);
+    --Size;
+    return 1;
+  }
 
-    // If erased node was the root, we need also replace it
-    if (getRoot() == NodeToErase) {
-      assignRoot(NodeToReplace);
+  /// @brief Take the element out of the tree together with its node.
+  ///
+  /// @return  The handle owning the node, empty if @p Position is end().
+  node_type extract(const_iterator Position) {
+    if (Position == end()) {
+      return {};
     }
+    auto ToExtract = mutableOf(Position);
+    auto *Extracted = ToExtract.getNode();
+    return {extractNode(Extracted, ++ToExtract), Allocator};
+  }
 
-    // Erased node could've been one (or even both) of the shortcuts
-    if (NodeToErase == getShortcut<utils::Direction::Left>()) {
-      decrementShortcut<utils::Direction::Left>();
+  node_type extract(const KeyType &Key) { return extract(find(Key)); }
+
+  /// @brief Link the node owned by the handle into the tree.
+  ///
+  /// If the tree already has an element with the same key, the handle keeps
+  /// the node.
+  ///
+  /// @pre  The allocator of the handle is equal to the one of this tree.
+  insert_return_type insert(node_type &&Handle) {
+    if (Handle.empty()) {
+      return {end(), false, {}};
     }
-    if (NodeToErase == getShortcut<utils::Direction::Right>()) {
-      decrementShortcut<utils::Direction::Right>();
+    assert(("Nodes can't change their allocators" &&
+            Allocator == *Handle.Allocator));
+    auto *ToInsert = Handle.Handled;
+    auto [Position, Inserted] = insertImpl(utils::Inserter{
+        [ToInsert]() -> auto & { return ToInsert->Key(); },
+        [&Handle]() { return Handle.release(); }});
+    if (Inserted) {
+      return {Position, true, {}};
     }
+    return {Position, false, std::move(Handle)};
+  }
 
-    destruct(NodeToErase);
-    --Size;
+  iterator insert(const_iterator Hint, node_type &&Handle) {
+    if (Handle.empty()) {
+      return end();
+    }
+    assert(("Nodes can't change their allocators" &&
+            Allocator == *Handle.Allocator));
+    auto *ToInsert = Handle.Handled;
+    return insertHintImpl(Hint, utils::Inserter{
+        [ToInsert]() -> auto & { return ToInsert->Key(); },
+        [&Handle]() { return Handle.release(); }}).first;
+  }
 
-    return ToErase;
+  /// @brief Move the elements with keys missing in this tree out of
+  /// @p Source.
+  ///
+  /// If the allocators of the trees are equal, nodes are relinked and
+  /// nothing is copied or reallocated.
+  template <class OtherCompare, class OtherPolicy>
+  void merge(SplayTree<KeyType, ValueType, OtherCompare, AllocatorType,
+                       OtherPolicy, Augmentation> &Source) {
+    const bool Relink = Allocator == Source.Allocator;
+    for (auto It = Source.begin(); It != Source.end();) {
+      auto *Candidate = Source.nodeOf(It);
+      ++It;
+      // The node leaves the source only when we know where it goes
+      insertImpl(utils::Inserter{
+          [Candidate]() -> auto & { return Candidate->Key(); },
+          [Candidate, Relink, &It, &Source, this]() {
+            if (Relink) {
+              return Source.extractNode(Candidate, It);
+            }
+            auto *Moved =
+                create(Candidate->Key(), std::move(Candidate->Value()));
+            Source.unlink(Candidate, It);
+            Source.destruct(Candidate);
+            return Moved;
+          }});
+    }
   }
 
   void clear() noexcept {
-    for (auto It = post_begin(), End = post_end(); It != End;
-         destruct((It++).getNode())) {
+    // Nothing to destroy, and if the allocator has nothing but our nodes,
+    // all of its memory can go at once.
+    bool Released = false;
+    if constexpr (utils::CanReleaseAtOnce<NodeAllocatorType> and
+                  std::is_trivially_destructible_v<KeyValuePairType> and
+                  std::is_trivially_destructible_v<Node>) {
+      if (Allocator.allocated() == Size) {
+        Allocator.release();
+        Released = true;
+      }
+    }
+    if (not Released) {
+      utils::destroyTree(getRoot(),
+                         [this](Node *ToDestroy) { destruct(ToDestroy); });
     }
     assignRoot(nullptr);
     adjustShortcut<utils::Direction::Left>(nullptr);
     adjustShortcut<utils::Direction::Right>(nullptr);
     Size = 0;
+    PendingUpdates = false;
   }
 
+  /// @brief Insert all of the key-value pairs from the range.
+  ///
+  /// The batch is sorted and merged into the tree in one pass: every run of
+  /// new keys falling between two neighboring nodes of the tree becomes
+  /// a balanced sub-tree hanging in that gap.  The tree is not splayed.
+  /// If there are equivalent keys, only the first one of them is inserted,
+  /// and keys that are already in the tree are skipped.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  void insert(InputIterator First, InputIterator Last) {
+    if (empty()) {
+      assign(First, Last);
+      return;
+    }
+
+    auto Batch = sortUnique(First, Last);
+    if constexpr (utils::CanReserve<NodeAllocatorType>) {
+      Allocator.reserve(Batch.size());
+    }
+
+    using BatchIterator = typename decltype(Batch)::iterator;
+    auto Create = [this](auto &&Pair) {
+      return create(std::forward<decltype(Pair)>(Pair));
+    };
+    auto Destroy = [this](Node *ToDestroy) { destruct(ToDestroy); };
+
+    // Nodes with the parts of the batch that go into their sub-trees
+    std::vector<std::tuple<Node *, BatchIterator, BatchIterator>> ToMerge{
+        {getRoot(), Batch.begin(), Batch.end()}};
+    // Every node is visited after its parent, so in the reverse order
+    // children go before parents.
+    std::vector<Node *> Visited;
+
+    auto Graft = [&](auto Direction, Node *Parent, BatchIterator Begin,
+                     BatchIterator End) {
+      if (Begin == End) {
+        return;
+      }
+      auto *&Child = utils::getChild<decltype(Direction)::value>(Parent);
+      if (Child != nullptr) {
+        ToMerge.emplace_back(Child, Begin, End);
+        return;
+      }
+      const std::size_t Count = End - Begin;
+      auto Source = std::make_move_iterator(Begin);
+      Child = utils::buildTree<Node>(Source, Count, Create, Destroy);
+      Child->Parent = Parent;
+      Size += Count;
+    };
+
+    auto IsLess = [this](const auto &Pair, const KeyType &Key) {
+      return Comparator(Pair.first, Key);
+    };
+    while (not ToMerge.empty()) {
+      auto [Current, Begin, End] = ToMerge.back();
+      ToMerge.pop_back();
+      // New sub-trees should not get pending updates of their parents
+      utils::pushAugmentation(Current);
+      if constexpr (utils::HasAugmentation<Node>) {
+        Visited.push_back(Current);
+      }
+
+      auto Lower = std::lower_bound(Begin, End, Current->Key(), IsLess);
+      auto Upper = Lower;
+      if (Upper != End and not Comparator(Current->Key(), Upper->first)) {
+        // This key is already in the tree
+        ++Upper;
+      }
+      Graft(LeftDirection{}, Current, Begin, Lower);
+      Graft(RightDirection{}, Current, Upper, End);
+    }
+    std::for_each(Visited.rbegin(), Visited.rend(),
+                  [](Node *ToUpdate) { utils::updateAugmentation(ToUpdate); });
+
+    adjustShortcut<utils::Direction::Left>(
+        Header.template getShortcut<utils::Direction::Left>());
+    adjustShortcut<utils::Direction::Right>(
+        Header.template getShortcut<utils::Direction::Right>());
+  }
+
+  /// @brief Erase all of the elements with the keys from the range.
+  ///
+  /// Keys are sorted first, so that every next erasure starts right next to
+  /// the previous one, which is cheap in a splay tree.
+  ///
+  /// @return  The number of erased elements.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  std::size_t erase_keys(InputIterator First, InputIterator Last) {
+    std::vector<KeyType> Keys(First, Last);
+    std::sort(Keys.begin(), Keys.end(), std::cref(Comparator));
+
+    std::size_t Erased = 0;
+    for (auto It = Keys.begin(); It != Keys.end(); ++It) {
+      // Equivalent keys go one after another
+      if (It != Keys.begin() and isEquivalent(*std::prev(It), *It)) {
+        continue;
+      }
+      Erased += erase(*It);
+    }
+    return Erased;
+  }
+
+  /// @brief Move all the elements with keys not less than @p Key into
+  /// a separate tree.
+  ///
+  /// Nodes are relinked, nothing is copied or reallocated.
+  ///
+  /// @return  The tree with the upper part, this tree keeps the lower part.
+  ///
+  /// @note  Iterators to the moved elements belong to the returned tree.
+  SplayTree split(const KeyType &Key) {
+    // Both parts keep splaying the same way
+    SplayTree Upper(Splayer);
+    Upper.Comparator = Comparator;
+    Upper.Allocator = Allocator;
+    Upper.PendingUpdates = PendingUpdates;
+    if (empty()) {
+      return Upper;
+    }
+
+    auto *OldRightmost = Header.template getShortcut<utils::Direction::Right>();
+    // After splaying, the root is one of the neighbors of the split point
+    auto *Root = splayClosest(Key);
+    // Sub-trees of the root are about to be separated
+    utils::pushAugmentation(Root);
+    Node *UpperRoot = nullptr;
+    if (Comparator(Root->Key(), Key)) {
+      UpperRoot = std::exchange(Root->Right, nullptr);
+      utils::updateAugmentation(Root);
+    } else {
+      UpperRoot = Root;
+      auto *LowerRoot = std::exchange(Root->Left, nullptr);
+      utils::updateAugmentation(Root);
+      utils::setParent(LowerRoot, &Header);
+      assignRoot(LowerRoot);
+      adjustShortcut<utils::Direction::Left>(LowerRoot);
+    }
+    adjustShortcut<utils::Direction::Right>(getRoot());
+
+    if (UpperRoot != nullptr) {
+      UpperRoot->Parent = &Upper.Header;
+      Upper.assignRoot(UpperRoot);
+      Upper.template adjustShortcut<utils::Direction::Left>(UpperRoot);
+      Upper.template setShortcut<utils::Direction::Right>(OldRightmost);
+    }
+
+    if constexpr (policy::CountsSubtrees<Augmentation>) {
+      Upper.Size = Augmentation::size(UpperRoot);
+    } else {
+      // Without sizes of sub-trees we have to count, but it is enough to
+      // count the smaller one of the two parts walking both of them at once.
+      auto LowerIt = begin(), UpperIt = Upper.begin();
+      std::size_t Steps = 0;
+      for (; LowerIt != end() and UpperIt != Upper.end();
+           ++LowerIt, ++UpperIt, ++Steps) {
+      }
+      Upper.Size = UpperIt == Upper.end() ? Steps : Size - Steps;
+    }
+    Size -= Upper.Size;
+    return Upper;
+  }
+
+  /// @brief Move all the elements of @p Other into this tree.
+  ///
+  /// Nodes are relinked, nothing is copied or reallocated.
+  ///
+  /// @pre  All keys of this tree are less than all keys of @p Other.
+  /// @pre  Allocators of both trees are equal.
+  void join(SplayTree &&Other) {
+    assert(("Nodes can't change their allocators" &&
+            Allocator == Other.Allocator));
+    assert(("Keys of the trees should not overlap" &&
+            (empty() or Other.empty() or
+             Comparator(std::prev(end())->first, Other.begin()->first))));
+
+    if (Other.empty()) {
+      return;
+    }
+    PendingUpdates |= std::exchange(Other.PendingUpdates, false);
+    if (empty()) {
+      moveHeader(std::move(Other.Header));
+      Size = std::exchange(Other.Size, 0);
+      return;
+    }
+
+    // The maximum has no right child when it is the root
+    auto *Maximum = Header.template getShortcut<utils::Direction::Right>();
+    utils::splay(static_cast<CompressedNode *>(Maximum));
+    // Pending updates of the maximum are not for the other tree
+    utils::pushAugmentation(Maximum);
+
+    auto *OtherRoot = Other.getRoot();
+    Maximum->Right = OtherRoot;
+    OtherRoot->Parent = Maximum;
+    utils::updateAugmentation(Maximum);
+    setShortcut<utils::Direction::Right>(
+        Other.Header.template getShortcut<utils::Direction::Right>());
+    Size += std::exchange(Other.Size, 0);
+
+    Other.assignRoot(nullptr);
+    Other.template setShortcut<utils::Direction::Left>(nullptr);
+    Other.template setShortcut<utils::Direction::Right>(nullptr);
+  }
+
+  /// @brief Stop (or resume) splaying on lookups.
+  ///
+  /// Lookups (find, contains, count, at and bounds) of a frozen tree don't
+  /// change its shape, so the tree can be read from many threads at once as
+  /// long as nobody modifies it.  Insertions and erasures still splay.
+  ///
+  /// @note  Statistics of the splaying policy are still collected, and that
+  ///        is not thread-safe.
+  void freeze(bool Freeze = true) {
+    Frozen = Freeze;
+    // Lookups should not push pending updates
+    if (Frozen) {
+      flush();
+    }
+  }
+  bool frozen() const { return Frozen; }
+
   bool contains(const KeyType &Key) { return find(Key) != end(); }
+  bool contains(const KeyType &Key) const {
+    return lookup(this, Key) != &Header;
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  bool contains(const KeyLike &Key) {
+    return find(Key) != end();
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  bool contains(const KeyLike &Key) const {
+    return lookup(this, Key) != &Header;
+  }
 
   std::size_t count(const KeyType &Key) { return contains(Key); }
+  std::size_t count(const KeyType &Key) const { return contains(Key); }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  std::size_t count(const KeyLike &Key) {
+    return contains(Key);
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  std::size_t count(const KeyLike &Key) const {
+    return contains(Key);
+  }
 
   ValueType &at(const KeyType &Key) {
     auto it = find(Key);
@@ -222,24 +897,422 @@ public:
     return it->second;
   }
 
+  const ValueType &at(const KeyType &Key) const {
+    auto it = find(Key);
+    if (it == end()) {
+      throw std::out_of_range("SplayTree::at");
+    }
+    return it->second;
+  }
+
   iterator find(const KeyType &Key) {
     auto *Root = getRoot();
+    if (Root == nullptr or Frozen) {
+      iterator Result{lookup(this, Key)};
+      recordLookup(Result != end());
+      return Result;
+    }
+
+    if constexpr (SplayPolicy::IsTopDown) {
+      Root = splayTopDown(Key);
+    } else {
+      // The last visited node is either the one we are looking for or one
+      // of its neighbors.  Misses splay it too, otherwise repeated misses in
+      // the same deep region would never get any cheaper.
+      Root = utils::find(Root, Key, Comparator).first;
+      splay(Root);
+    }
+
+    const bool Hit = isEquivalent(Root->Key(), Key);
+    recordLookup(Hit);
+    return Hit ? iterator{Root} : end();
+  }
+
+  /// @brief Find all of the given keys at once.
+  ///
+  /// Descents for groups of keys are interleaved and the next node of every
+  /// descent is prefetched, so that cache misses of different lookups
+  /// overlap.  The tree is splayed at most once per batch: the deepest found
+  /// node goes up.
+  ///
+  /// @param First, Last  The range of keys to look for.
+  /// @param Result  Output for iterators to found elements (or end()) in the
+  ///                order of the keys.
+  ///
+  /// @return  The output iterator past the last written result.
+  template <class ForwardIterator, class OutputIterator>
+  OutputIterator find_batch(ForwardIterator First, ForwardIterator Last,
+                            OutputIterator Result) {
+    probeBatch(First, Last, [this, &Result](Node *Found) {
+      *Result++ = Found != nullptr ? iterator{Found} : end();
+    });
+    return Result;
+  }
+
+  /// @brief Check the presence of all of the given keys at once.
+  ///
+  /// @see find_batch
+  template <class ForwardIterator, class OutputIterator>
+  OutputIterator contains_batch(ForwardIterator First, ForwardIterator Last,
+                                OutputIterator Result) {
+    probeBatch(First, Last,
+               [&Result](Node *Found) { *Result++ = Found != nullptr; });
+    return Result;
+  }
+
+  /// @brief Find the element without splaying the tree.
+  ///
+  /// @note  Lookups of lazily updated trees with pending updates push them
+  ///        on their way, see update_range().
+  const_iterator find(const KeyType &Key) const {
+    return {settledLookup(
+        [&Key](auto *This) { return lookup(This, Key); })};
+  }
+
+  /// @brief Find the element by a key of another type, which the comparator
+  /// can compare with keys, and splay it.
+  ///
+  /// The lower bound is the element if there is one.
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  iterator find(const KeyLike &Key) {
+    auto Found = bound<false>(Key);
+    const bool Hit = Found != end() and not Comparator(Key, Found->first);
+    recordLookup(Hit);
+    return Hit ? Found : end();
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  const_iterator find(const KeyLike &Key) const {
+    return {settledLookup(
+        [&Key](auto *This) { return lookup(This, Key); })};
+  }
 
-    if (Root != nullptr) {
+  /// @brief Find the first element which key is not less than @p Key.
+  iterator lower_bound(const KeyType &Key) { return bound<false>(Key); }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  iterator lower_bound(const KeyLike &Key) {
+    return bound<false>(Key);
+  }
+
+  const_iterator lower_bound(const KeyType &Key) const {
+    return {settledLookup(
+        [&Key](auto *This) { return lookupBound<false>(This, Key); })};
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  const_iterator lower_bound(const KeyLike &Key) const {
+    return {settledLookup(
+        [&Key](auto *This) { return lookupBound<false>(This, Key); })};
+  }
+
+  /// @brief Find the first element which key is greater than @p Key.
+  iterator upper_bound(const KeyType &Key) { return bound<true>(Key); }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  iterator upper_bound(const KeyLike &Key) {
+    return bound<true>(Key);
+  }
+
+  const_iterator upper_bound(const KeyType &Key) const {
+    return {settledLookup(
+        [&Key](auto *This) { return lookupBound<true>(This, Key); })};
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  const_iterator upper_bound(const KeyLike &Key) const {
+    return {settledLookup(
+        [&Key](auto *This) { return lookupBound<true>(This, Key); })};
+  }
+
+  std::pair<iterator, iterator> equal_range(const KeyType &Key) {
+    return equalRange(Key);
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const KeyLike &Key) {
+    return equalRange(Key);
+  }
+
+  std::pair<const_iterator, const_iterator>
+  equal_range(const KeyType &Key) const {
+    return {lower_bound(Key), upper_bound(Key)};
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  std::pair<const_iterator, const_iterator>
+  equal_range(const KeyLike &Key) const {
+    return {lower_bound(Key), upper_bound(Key)};
+  }
+
+  /// @brief Find the element with the given position in the sorted order and
+  /// splay it.
+  ///
+  /// @return  The iterator to the element or end() if @p Index is not less
+  ///          than the size of the tree.
+  ///
+  /// @pre  The tree is augmented with @ref policy::OrderStatistics.
+  iterator select(std::size_t Index) {
+    auto *Found = selectNode(this, Index);
+    if (Found != &Header) {
+      access(Found->getRealNode());
+    }
+    return {Found};
+  }
+
+  /// @brief Find the element with the given position in the sorted order
+  /// without splaying the tree.
+  const_iterator select(std::size_t Index) const {
+    return {settledLookup(
+        [Index](auto *This) { return selectNode(This, Index); })};
+  }
+
+  /// @brief Get the number of elements which keys are less than @p Key.
+  std::size_t rank(const KeyType &Key) { return indexOf(lower_bound(Key)); }
+  std::size_t rank(const KeyType &Key) const {
+    return indexOf(const_iterator{lookupBound<false>(this, Key)});
+  }
 
-      [[maybe_unused]] const auto [Parent, Node] =
-          utils::find(getRoot(), Key, Comparator);
-      if (Node) {
-        splay(Node);
-        return {getRoot()};
+  /// @brief Get the position of the element in the sorted order and splay it.
+  ///
+  /// @return  The position of the element, or the size of the tree for end().
+  std::size_t index_of(iterator Position) {
+    if (Position != end()) {
+      access(Position.getNode());
+    }
+    return indexOf(Position);
+  }
+
+  /// @brief Get the position of the element without splaying the tree.
+  std::size_t index_of(const_iterator Position) const {
+    return indexOf(Position);
+  }
+
+  /// @brief Get the number of increments from @p First to @p Last in
+  /// logarithmic amortized time.
+  difference_type distance(iterator First, iterator Last) {
+    const auto From = index_of(First);
+    return static_cast<difference_type>(index_of(Last)) -
+           static_cast<difference_type>(From);
+  }
+
+  difference_type distance(const_iterator First, const_iterator Last) const {
+    return static_cast<difference_type>(index_of(Last)) -
+           static_cast<difference_type>(index_of(First));
+  }
+
+  /// @brief Get the iterator @p Steps positions further than @p Position in
+  /// logarithmic amortized time.
+  ///
+  /// @return  The iterator to the found element, or end() if the position
+  ///          is out of the tree.
+  iterator next(iterator Position, difference_type Steps) {
+    return select(index_of(Position) + Steps);
+  }
+
+  const_iterator next(const_iterator Position, difference_type Steps) const {
+    return select(index_of(Position) + Steps);
+  }
+
+  /// @brief Get the aggregate of the elements with keys in [@p Lower, @p Upper)
+  /// and splay the boundaries of the range.
+  ///
+  /// Only the paths to both of the boundaries are walked, and the sub-trees
+  /// between them contribute with their aggregates.
+  ///
+  /// @pre  The tree is augmented with @ref policy::Aggregate.
+  auto aggregate(const KeyType &Lower, const KeyType &Upper) {
+    auto [Summary, LowerEnd, UpperEnd] = aggregateRange(this, Lower, Upper);
+    // Splaying the ends of the paths pays for walking them
+    if (LowerEnd != nullptr) {
+      access(LowerEnd);
+      if (UpperEnd != LowerEnd) {
+        access(UpperEnd);
       }
     }
+    return Summary;
+  }
 
-    return end();
+  /// @brief Get the aggregate of the elements with keys in [@p Lower, @p Upper)
+  /// without splaying the tree.
+  ///
+  /// Updates pending on the way are applied to the result, not to the tree.
+  auto aggregate(const KeyType &Lower, const KeyType &Upper) const {
+    return std::get<0>(aggregateRange(this, Lower, Upper));
+  }
+
+  /// @brief Get the aggregate of all the elements of the tree.
+  auto aggregate() const {
+    static_assert(policy::AggregatesValues<Augmentation>,
+                  "aggregates need policy::Aggregate augmentation");
+    return Augmentation::summary(getRoot());
+  }
+
+  /// @brief Apply the update to all of the values with keys in
+  /// [@p Lower, @p Upper) lazily and splay the boundaries of the range.
+  ///
+  /// Only the nodes on the paths to both of the boundaries are updated right
+  /// away, the sub-trees between them get the update pending.  Values found
+  /// with non-const lookups and mutable in-order iterators are always up to
+  /// date, as they push the updates on their way.  So are the values found
+  /// with const lookups: while updates are pending, they push them as well,
+  /// so such a tree should be flushed (or frozen) before it is shared
+  /// between readers.  Const aggregates take pending updates into account
+  /// without changing anything.  Const iterators, for_each() and gather()
+  /// need flush() first.
+  ///
+  /// @pre  The tree is augmented with @ref policy::Lazy.
+  ///
+  /// @note  Updates of frozen trees are flushed right away, so that lookups
+  ///        don't have to change anything.
+  template <class UpdateType>
+  void update_range(const KeyType &Lower, const KeyType &Upper,
+                    const UpdateType &ToApply) {
+    static_assert(policy::UpdatesLazily<Augmentation>,
+                  "range updates need policy::Lazy augmentation");
+    using Update = typename Augmentation::UpdateType;
+
+    auto [LowerEnd, Split, UpperEnd] = walkRange(
+        this, Lower, Upper,
+        [&ToApply](Node *Current, const auto &) {
+          Update::apply(ToApply, Current->Value());
+          Augmentation::apply(Current->Right, ToApply);
+        },
+        [&ToApply](Node *Current, const auto &) {
+          Update::apply(ToApply, Current->Value());
+        },
+        [&ToApply](Node *Current, const auto &) {
+          Augmentation::apply(Current->Left, ToApply);
+          Update::apply(ToApply, Current->Value());
+        });
+    if (Split != nullptr) {
+      // Nodes on the paths have new values, the upper path goes from the
+      // first node of the range, and the lower path goes through it up to
+      // the root.
+      for (auto *Current = UpperEnd; Current != Split;
+           Current = Current->Parent->getRealNode()) {
+        utils::updateAugmentation(Current);
+      }
+      updatePath(LowerEnd);
+      PendingUpdates = true;
+    }
+
+    if (LowerEnd != nullptr) {
+      // Splaying the ends of the paths pays for walking them
+      access(LowerEnd);
+      if (UpperEnd != LowerEnd) {
+        access(UpperEnd);
+      }
+    }
+    if (Frozen) {
+      flush();
+    }
+  }
+
+  /// @brief Apply all of the pending updates of values.
+  void flush() {
+    if (not PendingUpdates) {
+      return;
+    }
+    for (auto *Current = static_cast<CompressedNode *>(getRoot());
+         Current != nullptr and not Current->isHeader();
+         Current = utils::successorPreOrder<utils::Direction::Right>(Current)) {
+      utils::pushAugmentation(Current->getRealNode());
+    }
+    PendingUpdates = false;
+  }
+
+  /// @brief Change the value of the element in place and splay it.
+  ///
+  /// Augmentation data of the element and of all of its ancestors is updated
+  /// afterwards.  Values of augmented trees should be changed only this way.
+  ///
+  /// @param Position  The element to change, it should not be end().
+  /// @param Modifier  The function called with the reference to the value.
+  template <class ModifierType>
+  void modify(iterator Position, ModifierType Modifier) {
+    auto *ToModify = Position.getNode();
+    pushPath(ToModify);
+    std::invoke(Modifier, ToModify->Value());
+    updatePath(ToModify);
+    access(ToModify);
+  }
+
+  /// @brief Call @p Visitor with every key-value pair in [@p First, @p Last)
+  /// in order.
+  ///
+  /// It is the fastest way to scan the tree: unlike iterators, it doesn't
+  /// climb back up from every node.  The tree is not splayed.
+  ///
+  /// @note  Pending updates of values are not applied, call flush() first.
+  template <class VisitorType>
+  void for_each(const_iterator First, const_iterator Last,
+                VisitorType Visitor) const {
+    if (First == Last) {
+      return;
+    }
+    utils::visitInOrder(First.getNode(), Last.CorrespondingNode,
+                        [&Visitor](const Node *Visited) {
+                          std::invoke(Visitor, Visited->KeyValuePair());
+                          return true;
+                        });
+  }
+
+  template <class VisitorType> void for_each(VisitorType Visitor) const {
+    for_each(begin(), end(), std::move(Visitor));
+  }
+
+  template <class VisitorType> void for_each(VisitorType Visitor) {
+    flush();
+    std::as_const(*this).for_each(std::move(Visitor));
+  }
+
+  /// @brief Put pointers to the key-value pairs from [@p From, @p Last) into
+  /// the buffer, at most @p Capacity of them.
+  ///
+  /// Meant for scans in chunks: @p From moves past the gathered pairs, so
+  /// the next call picks up where this one stopped.  The tree is not
+  /// splayed.
+  ///
+  /// @return  The number of pairs put into the buffer.
+  ///
+  /// @note  Pending updates of values are not applied, call flush() first.
+  std::size_t gather(const_iterator &From, const_iterator Last,
+                     const KeyValuePairType **Buffer,
+                     std::size_t Capacity) const {
+    if (From == Last or Capacity == 0) {
+      return 0;
+    }
+    std::size_t Count = 0;
+    auto *Next = utils::visitInOrder(
+        From.getNode(), Last.CorrespondingNode,
+        [Buffer, Capacity, &Count](const Node *Visited) {
+          Buffer[Count++] = &Visited->KeyValuePair();
+          return Count < Capacity;
+        });
+    From = Next == nullptr ? end() : const_iterator{Next};
+    return Count;
   }
 
   // In-order iteration
-  iterator begin() { return {getShortcut<utils::Direction::Left>(this)}; }
+  iterator begin() {
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      // Mutable iterators push the rest of the updates on their way
+      for (auto *Current = PendingUpdates ? getRoot() : nullptr;
+           Current != nullptr; Current = Current->Left) {
+        utils::pushAugmentation(Current);
+      }
+    }
+    return {getShortcut<utils::Direction::Left>(this)};
+  }
   iterator end() { return {&Header}; }
   const_iterator begin() const {
     return {getShortcut<utils::Direction::Left>(this)};
@@ -257,11 +1330,15 @@ public:
 
   // Post-order iteration
   post_iterator post_begin() {
+    if (empty())
+      return post_end();
     return {utils::getTheOutmostLeaf<utils::Direction::Left>(
         getShortcut<utils::Direction::Left>(this))};
   }
   post_iterator post_end() { return {&Header}; }
   const_post_iterator post_begin() const {
+    if (empty())
+      return post_end();
     return {utils::getTheOutmostLeaf<utils::Direction::Left>(
         getShortcut<utils::Direction::Left>(this))};
   }
@@ -297,6 +1374,12 @@ public:
     return const_reverse_pre_iterator(pre_begin());
   }
 
+  const splay_policy &get_splay_policy() const { return Splayer; }
+
+  Compare key_comp() const { return Comparator; }
+
+  allocator_type get_allocator() const { return allocator_type(Allocator); }
+
   std::size_t size() const { return Size; }
   bool empty() const { return Size == 0; }
 
@@ -304,24 +1387,63 @@ private:
   template <class InserterType>
   std::pair<iterator, bool> insertImpl(InserterType Inserter) {
     auto *Root = getRoot();
+    Node *Inserted = nullptr;
 
     if (Root == nullptr) {
-      assignRoot(Inserter.getNode());
+      assignRoot(Inserted = Inserter.getNode());
       Root = getRoot();
       Root->Parent = &Header;
-      Header.Left = Root;
-      Header.Right = Root;
+      setShortcut<utils::Direction::Left>(Root);
+      setShortcut<utils::Direction::Right>(Root);
+
+    } else if constexpr (SplayPolicy::IsTopDown) {
+      // After top-down splaying, the root is either the node with the
+      // same key, or its future neighbor.
+      Root = splayTopDown(Inserter.getKey());
+      if (isEquivalent(Root->Key(), Inserter.getKey()))
+        return {{Root}, false};
+
+      Inserted = Inserter.getNode();
+      // The new node becomes the root and the old root goes to the side
+      if (Comparator(Inserted->Key(), Root->Key())) {
+        attach<utils::Direction::Left>(Inserted, Root);
+      } else {
+        attach<utils::Direction::Right>(Inserted, Root);
+      }
+      utils::updateAugmentation(Root);
+      utils::updateAugmentation(Inserted);
+      Inserted->Parent = &Header;
+      assignRoot(Inserted);
+
+      // The new root is the left/rightmost node iff it has no sub-tree
+      // in the corresponding direction.
+      if (Inserted->Left == nullptr)
+        setShortcut<utils::Direction::Left>(Inserted);
+      if (Inserted->Right == nullptr)
+        setShortcut<utils::Direction::Right>(Inserted);
+
     } else {
 
-      const auto [Parent, WhereTo] =
-          utils::find(Root, Inserter.getKey(), Comparator);
+      // The last visited node is either the node with the same key, or
+      // the parent of the new one.  The reference part of the result might
+      // point into the search's own frame when the root matches, so we
+      // never use it.
+      auto *Parent = utils::find(Root, Inserter.getKey(), Comparator).first;
 
       // We have a value with this key already
-      if (WhereTo)
-        return {{WhereTo}, false};
-
-      WhereTo = Inserter.getNode();
-      WhereTo->Parent = Parent;
+      if (isEquivalent(Parent->Key(), Inserter.getKey()))
+        return {{Parent}, false};
+
+      // The key might have been moved into the node, compare that one
+      Inserted = Inserter.getNode();
+      if (Comparator(Inserted->Key(), Parent->Key())) {
+        Parent->Left = Inserted;
+      } else {
+        Parent->Right = Inserted;
+      }
+      Inserted->Parent = Parent;
+      // Not every policy splays all the way up to the root
+      updatePath(Parent);
 
       // The new node could've become the left/rightmost node
       // in the tree and we need to make an adjustment to the
@@ -329,25 +1451,695 @@ private:
       //
       // It will take only O(1) time because it will become
       // either Header.Direction->Direction or stay Header.Direction
-      adjustShortcut<utils::Direction::Left>(Header.Left);
-      adjustShortcut<utils::Direction::Right>(Header.Right);
+      adjustShortcut<utils::Direction::Left>(
+          Header.template getShortcut<utils::Direction::Left>());
+      adjustShortcut<utils::Direction::Right>(
+          Header.template getShortcut<utils::Direction::Right>());
 
-      splay(WhereTo);
+      splay(Inserted);
     }
 
     ++Size;
 
-    return {{Root}, true};
+    return {{Inserted}, true};
+  }
+
+  /// @brief Insert the node between the hint and its neighbor, or fall back
+  /// to the regular insertion if the hint is wrong.
+  template <class InserterType>
+  std::pair<iterator, bool> insertHintImpl(const_iterator Hint,
+                                           InserterType Inserter) {
+    if (Size == 0) {
+      return insertImpl(Inserter);
+    }
+
+    // The new key should fall between two neighbors, one of them is the
+    // hint.  The header stands for the missing neighbor at either end.
+    CompressedNode *Lower = nullptr, *Upper = nullptr;
+    auto *Hinted = mutableOf(Hint).CorrespondingNode;
+    const auto &Key = Inserter.getKey();
+    if (Hinted == &Header or Comparator(Key, Hinted->getRealNode()->Key())) {
+      Upper = Hinted;
+      Lower = neighborOf<utils::Direction::Left>(Hinted);
+      if (Lower != &Header and
+          not Comparator(Lower->getRealNode()->Key(), Key)) {
+        return isEquivalent(Lower->getRealNode()->Key(), Key)
+                   ? std::pair{iterator{Lower}, false}
+                   : insertImpl(Inserter);
+      }
+    } else if (Comparator(Hinted->getRealNode()->Key(), Key)) {
+      Lower = Hinted;
+      Upper = neighborOf<utils::Direction::Right>(Hinted);
+      if (Upper != &Header and
+          not Comparator(Key, Upper->getRealNode()->Key())) {
+        return isEquivalent(Upper->getRealNode()->Key(), Key)
+                   ? std::pair{iterator{Upper}, false}
+                   : insertImpl(Inserter);
+      }
+    } else {
+      return {{Hinted}, false};
+    }
+
+    // Out of two adjacent nodes, either the lower one has no right child,
+    // or the upper one has no left child.
+    const bool UnderLower = Lower != &Header and Lower->Right == nullptr;
+    auto *Parent = (UnderLower ? Lower : Upper)->getRealNode();
+    assert(("The new node should have a free place" &&
+            (UnderLower or Parent->Left == nullptr)));
+    // Pending updates of the parent are not for the new node
+    pushPath(Parent);
+    utils::pushAugmentation(Parent);
+
+    auto *Inserted = Inserter.getNode();
+    (UnderLower ? Parent->Right : Parent->Left) = Inserted;
+    Inserted->Parent = Parent;
+    updatePath(Parent);
+
+    if (Lower == &Header) {
+      setShortcut<utils::Direction::Left>(Inserted);
+    }
+    if (Upper == &Header) {
+      setShortcut<utils::Direction::Right>(Inserted);
+    }
+    ++Size;
+
+    access(Inserted);
+    return {{Inserted}, true};
+  }
+
+  /// The in-order neighbor of the node, or the header past either end.
+  /// The ends are known from the shortcuts, so it takes constant time there
+  /// instead of climbing the whole spine.
+  template <utils::Direction To>
+  CompressedNode *neighborOf(CompressedNode *Of) {
+    if (Of != &Header and Of == getShortcut<To>()) {
+      return &Header;
+    }
+    return utils::successorInOrder<To>(Of);
+  }
+
+  /// Make the given node the new parent of the old root, so that the old
+  /// root and its sub-tree from the opposite direction become its children.
+  template <utils::Direction To> void attach(Node *NewRoot, Node *OldRoot) {
+    constexpr auto From = utils::invert(To);
+    auto *Child = utils::getChild<To>(OldRoot);
+
+    utils::getChild<To>(NewRoot) = Child;
+    if (Child)
+      Child->Parent = NewRoot;
+    utils::getChild<To>(OldRoot) = nullptr;
+
+    utils::getChild<From>(NewRoot) = OldRoot;
+    OldRoot->Parent = NewRoot;
+  }
+
+  /// Take the node out of the tree without destroying it.
+  void unlink(Node *NodeToErase, iterator Successor) {
+    releaseShortcuts(NodeToErase);
+    if constexpr (SplayPolicy::IsTopDown) {
+      unlinkTopDown(NodeToErase);
+    } else {
+      unlinkBottomUp(NodeToErase, Successor);
+    }
+    --Size;
+  }
+
+  /// Erased node could've been one (or even both) of the shortcuts.
+  /// We should update them while the node is still in the tree.
+  void releaseShortcuts(Node *NodeToErase) {
+    if (NodeToErase == getShortcut<utils::Direction::Left>()) {
+      decrementShortcut<utils::Direction::Left>();
+    }
+    if (NodeToErase == getShortcut<utils::Direction::Right>()) {
+      decrementShortcut<utils::Direction::Right>();
+    }
+  }
+
+  void unlinkBottomUp(Node *NodeToErase, iterator Successor) {
+    Node *NodeToReplace = nullptr;
+
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      // Children of the node and the successor move, and so should their
+      // pending updates.  Updates of the nodes above apply to all of them.
+      for (auto *Current = NodeToErase; Current != nullptr;
+           Current = Current == NodeToErase ? Current->Right : Current->Left) {
+        utils::pushAugmentation(Current);
+      }
+    }
+
+    // Check if we have both sub-trees...
+    if (NodeToErase->Right == nullptr) {
+      // ...if we don't have the right one, we can simply replace the node of
+      // interest with its left child.
+      NodeToReplace = NodeToErase->Left;
+    } else if (NodeToErase->Left == nullptr) {
+      // ...the same goes for the right child.
+      NodeToReplace = NodeToErase->Right;
+    } else {
+      // ...otherwise the successor of our node is in the right sub-tree.
+      // We can swap the node of interest with its successor.
+      utils::swap(NodeToErase, Successor.getNode());
+      // Successor could've had only the right child (otherwise its
+      // left child would've been a successor).
+      NodeToReplace = NodeToErase->Right;
+    }
+
+    // Even if the child doesn't exist it is still a valid replacement.
+    // If erased node was the root, the header gets the new root as well.
+    utils::replace(NodeToErase, NodeToReplace);
+    // The parent is still there, and the successor (if it moved) is on the
+    // way from it to the root.
+    if (not NodeToErase->isRoot()) {
+      updatePath(NodeToErase->Parent->getRealNode());
+    }
+  }
+
+  void unlinkTopDown(Node *NodeToErase) {
+    // Bring the node to the top and join its sub-trees after that
+    auto *Root = splayTopDown(NodeToErase->Key());
+    assert(("Splaying should find the node" && Root == NodeToErase));
+    unlinkRoot(Root);
+  }
+
+  /// Join the sub-trees of the root in its place.
+  void unlinkRoot(Node *Root) {
+    Node *NewRoot = Root->Right;
+    if (Root->Left) {
+      // Every key in the left sub-tree is less than the key of the erased
+      // node and splaying it by this key brings its maximum to the top.
+      // The maximum has no right child, and the right sub-tree goes there.
+      NewRoot = utils::splayTopDown(Root->Left, Root->Key(), Comparator);
+      NewRoot->Right = Root->Right;
+      if (Root->Right)
+        Root->Right->Parent = NewRoot;
+      utils::updateAugmentation(NewRoot);
+    }
+
+    if (NewRoot)
+      NewRoot->Parent = &Header;
+    assignRoot(NewRoot);
   }
 
-  void splay(CompressedNode *NodeToMoveToTheTop) {
-    utils::splay(NodeToMoveToTheTop);
-    assignRoot(NodeToMoveToTheTop);
+  /// Unlink the node and turn it into a tree of its own, ready to be linked
+  /// into another tree.
+  Node *extractNode(Node *ToExtract, iterator Successor) {
+    // Pending updates of the ancestors are for the node as well
+    pushPath(ToExtract);
+    unlink(ToExtract, Successor);
+    ToExtract->Left = ToExtract->Right = nullptr;
+    ToExtract->Parent = nullptr;
+    utils::updateAugmentation(ToExtract);
+    return ToExtract;
   }
 
-  void copyTree(const HeaderType &Origin) {
+  template <class KeyLike> Node *splayTopDown(const KeyLike &Key) {
+    auto *NewRoot = utils::splayTopDown(getRoot(), Key, Comparator);
+    assignRoot(NewRoot);
+    return NewRoot;
+  }
+
+  using LeftDirection =
+      std::integral_constant<utils::Direction, utils::Direction::Left>;
+  using RightDirection =
+      std::integral_constant<utils::Direction, utils::Direction::Right>;
+
+  /// Copy key-value pairs from the range, sort them by keys and leave only
+  /// the first one of equivalent keys.
+  template <class InputIterator>
+  std::vector<std::pair<KeyType, ValueType>> sortUnique(InputIterator First,
+                                                        InputIterator Last) {
+    std::vector<std::pair<KeyType, ValueType>> Result(First, Last);
+    // Stable sort keeps the first one of equivalent keys in the front
+    std::stable_sort(Result.begin(), Result.end(),
+                     [this](const auto &LHS, const auto &RHS) {
+                       return Comparator(LHS.first, RHS.first);
+                     });
+    Result.erase(std::unique(Result.begin(), Result.end(),
+                             [this](const auto &LHS, const auto &RHS) {
+                               return isEquivalent(LHS.first, RHS.first);
+                             }),
+                 Result.end());
+    return Result;
+  }
+
+  /// Find the first node that is not less than (@p Strict is false) or is
+  /// greater than (@p Strict is true) the given key and splay it.
+  template <bool Strict, class KeyLike> iterator bound(const KeyLike &Key) {
+    auto *Root = getRoot();
+    if (Root == nullptr or Frozen) {
+      return {lookupBound<Strict>(this, Key)};
+    }
+
+    if constexpr (SplayPolicy::IsTopDown) {
+      // The new root is either the bound or the node right before it
+      Root = splayTopDown(Key);
+      iterator Result{Root};
+      if (isBefore<Strict>(Root, Key) and ++Result != end()) {
+        // The successor is down in the right sub-tree of the root
+        pushPath(Result.getNode());
+      }
+      return Result;
+    } else {
+      auto [Last, Found] =
+          utils::partitionPoint(Root, [this, &Key](const Node *Candidate) {
+            return isBefore<Strict>(Candidate, Key);
+          });
+      // If there is no bound, the last visited node is the maximum, and we
+      // still want to splay it to pay for the long search path.
+      splay(Found != nullptr ? Found : Last);
+      return Found != nullptr ? iterator{Found} : end();
+    }
+  }
+
+  /// Check if the node goes before the first node that is not less than
+  /// (@p Strict is false) or is greater than (@p Strict is true) the key.
+  template <bool Strict, class KeyLike>
+  bool isBefore(const Node *Candidate, const KeyLike &Key) const {
+    if constexpr (Strict) {
+      return not Comparator(Key, Candidate->Key());
+    } else {
+      return Comparator(Candidate->Key(), Key);
+    }
+  }
+
+  /// Search for the node with the given key without changing the tree.
+  ///
+  /// @return  The found node or the header if there is no such node.
+  template <class ThisPointer, class KeyLike>
+  static auto *lookup(ThisPointer This, const KeyLike &Key) {
+    // The lower bound is the node we are looking for if there is one
+    auto *Found = lookupBound<false>(This, Key);
+    if (Found != &This->Header and
+        This->Comparator(Key, Found->getRealNode()->Key())) {
+      return &This->Header;
+    }
+    return Found;
+  }
+
+  /// Search for the bound without changing the tree.
+  ///
+  /// @return  The found node or the header if there is no such node.
+  template <bool Strict, class ThisPointer, class KeyLike>
+  static auto *lookupBound(ThisPointer This, const KeyLike &Key) {
+    using ResultType = decltype(&This->Header);
+    auto *Found = utils::partitionPoint(
+                      This->getRoot(),
+                      [This, &Key](const Node *Candidate) {
+                        return This->template isBefore<Strict>(Candidate, Key);
+                      })
+                      .second;
+    return Found != nullptr ? static_cast<ResultType>(Found) : &This->Header;
+  }
+
+
+  template <class KeyLike>
+  std::pair<iterator, iterator> equalRange(const KeyLike &Key) {
+    // Keys are unique, the range has at most one element
+    auto Lower = bound<false>(Key), Upper = Lower;
+    if (Upper != end() and not Comparator(Key, Upper->first) and
+        ++Upper != end()) {
+      // Lookups should see up-to-date values, the successor included
+      pushPath(Upper.getNode());
+    }
+    return {Lower, Upper};
+  }
+
+  void recordLookup([[maybe_unused]] bool Hit) {
+    if constexpr (policy::RecordsLookups<SplayPolicy>) {
+      Splayer.recordLookup(Hit);
+    }
+  }
+
+  /// Look for the keys from the range in groups of interleaved descents and
+  /// report found nodes (or nulls) to @p Report in the order of the keys.
+  template <class ForwardIterator, class ReportFunction>
+  void probeBatch(ForwardIterator First, ForwardIterator Last,
+                  ReportFunction Report) {
+    // Enough independent descents to cover the memory latency
+    constexpr std::size_t GroupSize = 8;
+    ForwardIterator Keys[GroupSize];
+    Node *Current[GroupSize], *Found[GroupSize];
+
+    Node *Deepest = nullptr;
+    std::size_t DeepestLevel = 0;
+
+    while (First != Last) {
+      std::size_t Count = 0;
+      for (; Count < GroupSize and First != Last; ++Count, ++First) {
+        Keys[Count] = First;
+        Current[Count] = getRoot();
+        Found[Count] = nullptr;
+      }
+
+      // Every round makes one step down in every unfinished descent
+      for (std::size_t Level = 0, Active = Count; Active != 0; ++Level) {
+        Active = 0;
+        for (std::size_t Index = 0; Index < Count; ++Index) {
+          Node *Candidate = Current[Index];
+          if (Candidate == nullptr) {
+            continue;
+          }
+
+          const auto &Key = *Keys[Index];
+          utils::pushAugmentation(Candidate);
+          if (Comparator(Key, Candidate->Key())) {
+            Current[Index] = Candidate->Left;
+          } else if (Comparator(Candidate->Key(), Key)) {
+            Current[Index] = Candidate->Right;
+          } else {
+            Found[Index] = Candidate;
+            Current[Index] = nullptr;
+            if (Level >= DeepestLevel) {
+              Deepest = Candidate;
+              DeepestLevel = Level;
+            }
+            continue;
+          }
+
+          if (Current[Index] != nullptr) {
+            utils::prefetch(Current[Index]);
+            ++Active;
+          }
+        }
+      }
+
+      for (std::size_t Index = 0; Index < Count; ++Index) {
+        recordLookup(Found[Index] != nullptr);
+        Report(Found[Index]);
+      }
+    }
+
+    if (Deepest != nullptr) {
+      access(Deepest);
+    }
+  }
+
+  /// Bring the node with the given key, or one of its neighbors if there is
+  /// no such key, to the root.
+  Node *splayClosest(const KeyType &Key) {
+    if constexpr (SplayPolicy::IsTopDown) {
+      return splayTopDown(Key);
+    } else {
+      // The last visited node is exactly what we need, and it should
+      // become the root no matter what the policy says.
+      auto *Closest = utils::find(getRoot(), Key, Comparator).first;
+      utils::splay(static_cast<CompressedNode *>(Closest));
+      return Closest;
+    }
+  }
+
+  /// Find the node with the given position in the sorted order.
+  ///
+  /// @return  The found node or the header if there is no such node.
+  template <class ThisPointer>
+  static auto *selectNode(ThisPointer This, std::size_t Index) {
+    static_assert(policy::CountsSubtrees<Augmentation>,
+                  "positions need sizes of sub-trees");
+    using ResultType = decltype(&This->Header);
+    for (auto *Current = This->getRoot(); Current != nullptr;) {
+      utils::pushAugmentation(Current);
+      const std::size_t LeftSize = Augmentation::size(Current->Left);
+      if (Index < LeftSize) {
+        Current = Current->Left;
+      } else if (Index == LeftSize) {
+        return static_cast<ResultType>(Current);
+      } else {
+        Index -= LeftSize + 1;
+        Current = Current->Right;
+      }
+    }
+    return &This->Header;
+  }
+
+  /// Count the nodes going before the given one walking up to the root.
+  template <class IteratorType>
+  std::size_t indexOf(IteratorType Position) const {
+    static_assert(policy::CountsSubtrees<Augmentation>,
+                  "positions need sizes of sub-trees");
+    if (Position.CorrespondingNode->isHeader()) {
+      return Size;
+    }
+    const Node *Current = Position.getNode();
+    std::size_t Index = Augmentation::size(Current->Left);
+    for (; not Current->isRoot(); Current = Current->Parent->getRealNode()) {
+      // Everything in the left sub-tree of the parent and the parent itself
+      // go before the right child
+      if (utils::isChild<utils::Direction::Right>(Current)) {
+        Index += Augmentation::size(Current->Parent->Left) + 1;
+      }
+    }
+    return Index;
+  }
+
+  /// Walk down the paths to both of the boundaries of [@p Lower, @p Upper)
+  /// reporting the parts of the range along the way.
+  ///
+  /// The paths go together down to the first node of the range, which is
+  /// reported to @p OnSplit.  Then going left on the lower path means that
+  /// the node and its right sub-tree are in the range and go before all the
+  /// parts of the lower path reported so far, these nodes are reported to
+  /// @p OnLower.  The upper path is the mirror image of the lower one: the
+  /// left sub-tree and the node of @p OnUpper go after the reported parts.
+  ///
+  /// Every reported node comes with the updates pending above it, which
+  /// const walks can't push down (see pendingBelow).
+  ///
+  /// @return  The last nodes of the paths to the lower and the upper
+  ///          boundaries (or nulls for the empty tree) with the first node
+  ///          of the range (or null for the empty range) in between.
+  template <class ThisPointer, class LowerVisitor, class SplitVisitor,
+            class UpperVisitor>
+  static auto walkRange(ThisPointer This, const KeyType &Lower,
+                        const KeyType &Upper, LowerVisitor OnLower,
+                        SplitVisitor OnSplit, UpperVisitor OnUpper) {
+    const auto &Comparator = This->Comparator;
+
+    // Nodes above the first node of the range are out of the range
+    auto *Split = This->getRoot();
+    decltype(Split) Last = nullptr;
+    auto Above = nothingPending();
+    while (Split != nullptr) {
+      Last = Split;
+      utils::pushAugmentation(Split);
+      if (Comparator(Split->Key(), Lower)) {
+        Above = pendingBelow(Split, Above);
+        Split = Split->Right;
+      } else if (not Comparator(Split->Key(), Upper)) {
+        Above = pendingBelow(Split, Above);
+        Split = Split->Left;
+      } else {
+        break;
+      }
+    }
+    if (Split == nullptr) {
+      return std::tuple{Last, Split, Last};
+    }
+    OnSplit(Split, Above);
+
+    auto *LowerEnd = Split;
+    auto LowerAbove = pendingBelow(Split, Above);
+    for (auto *Current = Split->Left; Current != nullptr;) {
+      LowerEnd = Current;
+      utils::pushAugmentation(Current);
+      if (Comparator(Current->Key(), Lower)) {
+        LowerAbove = pendingBelow(Current, LowerAbove);
+        Current = Current->Right;
+      } else {
+        OnLower(Current, LowerAbove);
+        LowerAbove = pendingBelow(Current, LowerAbove);
+        Current = Current->Left;
+      }
+    }
+
+    auto *UpperEnd = Split;
+    auto UpperAbove = pendingBelow(Split, Above);
+    for (auto *Current = Split->Right; Current != nullptr;) {
+      UpperEnd = Current;
+      utils::pushAugmentation(Current);
+      if (not Comparator(Current->Key(), Upper)) {
+        UpperAbove = pendingBelow(Current, UpperAbove);
+        Current = Current->Left;
+      } else {
+        OnUpper(Current, UpperAbove);
+        UpperAbove = pendingBelow(Current, UpperAbove);
+        Current = Current->Right;
+      }
+    }
+    return std::tuple{LowerEnd, Split, UpperEnd};
+  }
+
+  /// Aggregate the elements with keys in [@p Lower, @p Upper).
+  ///
+  /// @return  The aggregate and the last nodes of the paths to the lower and
+  ///          the upper boundaries.
+  template <class ThisPointer>
+  static auto aggregateRange(ThisPointer This, const KeyType &Lower,
+                             const KeyType &Upper) {
+    static_assert(policy::AggregatesValues<Augmentation>,
+                  "aggregates need policy::Aggregate augmentation");
+    using Monoid = typename Augmentation::MonoidType;
+
+    auto LowerPart = Monoid::identity(), Middle = Monoid::identity(),
+         UpperPart = Monoid::identity();
+    [[maybe_unused]] auto [LowerEnd, Split, UpperEnd] = walkRange(
+        This, Lower, Upper,
+        [&LowerPart](const Node *Current, const auto &Above) {
+          LowerPart = Monoid::combine(
+              Monoid::combine(liftUnder(Current, Above),
+                              summaryUnder(Current->Right,
+                                           pendingBelow(Current, Above))),
+              LowerPart);
+        },
+        [&Middle](const Node *Current, const auto &Above) {
+          Middle = liftUnder(Current, Above);
+        },
+        [&UpperPart](const Node *Current, const auto &Above) {
+          UpperPart = Monoid::combine(
+              UpperPart,
+              Monoid::combine(
+                  summaryUnder(Current->Left, pendingBelow(Current, Above)),
+                  liftUnder(Current, Above)));
+        });
+
+    return std::tuple{
+        Monoid::combine(Monoid::combine(LowerPart, Middle), UpperPart),
+        LowerEnd, UpperEnd};
+  }
+
+  /// Nothing is pending above the root.
+  static auto nothingPending() {
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      return Augmentation::UpdateType::identity();
+    } else {
+      return std::tuple{};
+    }
+  }
+
+  /// Updates pending for the children of the node: its own and the ones
+  /// pending above it.  Walks which push updates down as they go never have
+  /// anything pending, only const walks carry updates this way.
+  template <class AboveType>
+  static AboveType pendingBelow([[maybe_unused]] const Node *Current,
+                               const AboveType &Above) {
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      return Augmentation::UpdateType::compose(Current->Pending, Above);
+    } else {
+      return Above;
+    }
+  }
+
+  /// The aggregate of the element with the updates pending above it.
+  template <class AboveType>
+  static auto liftUnder(const Node *Current,
+                        [[maybe_unused]] const AboveType &Above) {
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      if (not(Above == nothingPending())) {
+        auto Value = Current->Value();
+        Augmentation::UpdateType::apply(Above, Value);
+        return Augmentation::MonoidType::lift(Current->Key(), Value);
+      }
+    }
+    return Augmentation::lift(Current);
+  }
+
+  /// The aggregate of the sub-tree with the updates pending above it.
+  template <class AboveType>
+  static auto summaryUnder(const Node *SubTree,
+                           [[maybe_unused]] const AboveType &Above) {
+    auto Summary = Augmentation::summary(SubTree);
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      if (SubTree != nullptr) {
+        Augmentation::UpdateType::apply(Above, Summary,
+                                        Augmentation::size(SubTree));
+      }
+    }
+    return Summary;
+  }
+
+  /// Run the lookup, which takes the tree, so that the found value is up to
+  /// date.  The tree owns its nodes, and pending updates of values can be
+  /// pushed on the way even through const access.
+  template <class LookupType>
+  const CompressedNode *settledLookup(LookupType Lookup) const {
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      if (PendingUpdates) {
+        return Lookup(const_cast<SplayTree *>(this));
+      }
+    }
+    return Lookup(this);
+  }
+
+  /// Push pending updates down the path from the root to the node, so that
+  /// the node has all of them.
+  void pushPath([[maybe_unused]] Node *Bottom) {
+    if constexpr (utils::HasLazyUpdates<Node>) {
+      std::vector<Node *> Path;
+      for (auto *Current = static_cast<CompressedNode *>(Bottom);
+           not Current->isRoot(); Current = Current->Parent) {
+        Path.push_back(Current->Parent->getRealNode());
+      }
+      std::for_each(Path.rbegin(), Path.rend(),
+                    [](Node *ToPush) { utils::pushAugmentation(ToPush); });
+    }
+  }
+
+  /// Splay the node all the way to the root, whatever the policy is.
+  void bringToRoot(Node *ToSplay) {
+    if constexpr (SplayPolicy::IsTopDown) {
+      splayTopDown(ToSplay->Key());
+    } else {
+      utils::splay(static_cast<CompressedNode *>(ToSplay));
+    }
+  }
+
+  /// Splay the node as if it was just found.
+  void access(Node *Accessed) {
+    if (Frozen) {
+      return;
+    }
+    if constexpr (SplayPolicy::IsTopDown) {
+      splayTopDown(Accessed->Key());
+    } else {
+      splay(Accessed);
+    }
+  }
+
+  bool isEquivalent(const KeyType &LHS, const KeyType &RHS) const {
+    return not Comparator(LHS, RHS) and not Comparator(RHS, LHS);
+  }
+
+  static Node *nodeOf(iterator Position) { return Position.getNode(); }
+
+  /// The tree owns its nodes, so it can change what const iterators refer to.
+  static iterator mutableOf(const_iterator Position) {
+    return {const_cast<CompressedNode *>(Position.CorrespondingNode)};
+  }
+
+  /// Let the policy decide how far up the accessed node goes, rotations
+  /// keep the root of the tree up-to-date.
+  void splay(CompressedNode *Accessed) { Splayer(Accessed); }
+
+  /// Update the augmentation data of the node and all of its ancestors.
+  void updatePath([[maybe_unused]] Node *Bottom) {
+    if constexpr (utils::HasAugmentation<Node>) {
+      for (auto *Current = static_cast<CompressedNode *>(Bottom);
+           not Current->isHeader(); Current = Current->Parent) {
+        utils::updateAugmentation(Current->getRealNode());
+      }
+    }
+  }
+
+  void copyTree(const HeaderType &Origin, std::size_t Count) {
+    if constexpr (utils::CanReserve<NodeAllocatorType>) {
+      // Copies are created in pre-order, so that they go one after another
+      // in memory in the order of the search paths
+      Allocator.reserve(Count);
+    }
     Header = utils::copyTree(Origin, [this](const Node &ToCopy) {
-      return create(ToCopy.KeyValuePair());
+      auto *Copy = create(ToCopy.KeyValuePair());
+      // The shape of the tree is the same, and so is the data about it
+      static_cast<typename Augmentation::Data &>(*Copy) = ToCopy;
+      return Copy;
     });
 
     if (Header.Parent) {
@@ -364,21 +2156,33 @@ private:
     ::new (DataChunk) Node;
     std::allocator_traits<NodeAllocatorType>::construct(
         Allocator, DataChunk->Pointer(), std::forward<ArgsTypes>(Args)...);
+    // The data of a single node might depend on its key and value
+    utils::updateAugmentation(DataChunk);
     return DataChunk;
   }
 
-  void destruct(Node *ToDealloc) {
-    std::allocator_traits<NodeAllocatorType>::destroy(Allocator, ToDealloc);
+  void destruct(Node *ToDealloc) { destruct(ToDealloc, Allocator); }
+
+  static void destruct(Node *ToDealloc, NodeAllocatorType &Allocator) {
+    std::allocator_traits<NodeAllocatorType>::destroy(Allocator,
+                                                      ToDealloc->Pointer());
+    // The augmentation data was constructed together with the node
+    ToDealloc->~Node();
     std::allocator_traits<NodeAllocatorType>::deallocate(Allocator, ToDealloc,
                                                          1);
   }
 
   Node *getRoot() { return Header.getRoot(); }
+  const Node *getRoot() const { return Header.getRoot(); }
   void assignRoot(CompressedNode *NewRoot) { Header.Parent = NewRoot; }
 
   template <utils::Direction Which> void adjustShortcut(Node *Pivot) {
-    utils::getChild<Which>(&Header) =
-        Pivot == nullptr ? nullptr : utils::getTheOutmost<Which>(Pivot);
+    setShortcut<Which>(Pivot == nullptr ? nullptr
+                                        : utils::getTheOutmost<Which>(Pivot));
+  }
+
+  template <utils::Direction Which> void setShortcut(Node *Shortcut) {
+    Header.template setShortcut<Which>(Shortcut);
   }
 
   template <utils::Direction Which> auto *getShortcut() {
@@ -389,11 +2193,11 @@ private:
   static auto *getShortcut(ThisPointer Pointer) {
     return Pointer->Header.Parent == nullptr
                ? &Pointer->Header
-               : utils::getChild<Which>(&Pointer->Header);
+               : Pointer->Header.template getShortcut<Which>();
   }
 
   template <utils::Direction Which> void decrementShortcut() {
-    auto &Shortcut = utils::getChild<Which>(&Header);
+    auto *Shortcut = Header.template getShortcut<Which>();
     // if the shortcut is the left/rightmost leaf in the tree,
     // than the next node from that order will be its successor node from
     // the oposite direction
@@ -401,17 +2205,23 @@ private:
         static_cast<CompressedNode *>(Shortcut));
     if (TheSecondOutmostNode == &Header) {
       // there is no second outmost element, the shortcut should become null
-      Shortcut = nullptr;
+      setShortcut<Which>(nullptr);
     } else {
       // it couldn't be a header (it should be only one header in a tree)
-      Shortcut = TheSecondOutmostNode->getRealNode();
+      setShortcut<Which>(TheSecondOutmostNode->getRealNode());
     }
   }
 
+  // Trees with other comparators and policies can take each other's nodes
+  template <class, class, class, class, class, class> friend class SplayTree;
+
   HeaderType Header{true};
   std::size_t Size = 0;
   Compare Comparator{};
   NodeAllocatorType Allocator{};
+  SplayPolicy Splayer{};
+  bool Frozen = false;
+  bool PendingUpdates = false;
 };
 
 } // end namespace hammock::impl
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace hammock::policy {
+
+/// @brief Nodes carry nothing but the key-value pair.
+///
+/// Every augmentation has the @c Data, which is stored in every node, and
+/// the @c update function, which recomputes the data of the node from its
+/// own key-value pair and the data of its children.  The tree calls it
+/// bottom-up for every node that changes its children.
+struct NoAugmentation {
+  struct Data {};
+
+  template <class NodeType> static void update(NodeType *) {}
+};
+
+/// @brief Every node knows the size of its sub-tree.
+///
+/// It makes possible finding the element by its position in the sorted
+/// order and the position of the element in logarithmic (amortized) time.
+struct OrderStatistics {
+  struct Data {
+    std::size_t SubtreeSize = 1;
+  };
+
+  template <class NodeType> static void update(NodeType *Node) {
+    Node->SubtreeSize = 1 + size(Node->Left) + size(Node->Right);
+  }
+
+  template <class NodeType> static std::size_t size(const NodeType *Node) {
+    return Node != nullptr ? Node->SubtreeSize : 0;
+  }
+};
+
+/// True if the augmentation keeps sizes of sub-trees.
+template <class Augmentation>
+constexpr inline bool CountsSubtrees =
+    std::is_base_of_v<OrderStatistics, Augmentation>;
+
+/// @brief Every node keeps the aggregate of all the elements of its sub-tree.
+///
+/// It makes possible aggregating any range of keys in logarithmic
+/// (amortized) time.
+///
+/// @tparam Monoid  Type with an associative operation over aggregates:
+///                 - @c value_type is the type of aggregates;
+///                 - @c identity() is the aggregate of nothing;
+///                 - @c combine(LHS, RHS) is the aggregate of two adjacent
+///                   ranges, it doesn't have to be commutative;
+///                 - @c lift(Key, Value) is the aggregate of one element.
+///
+/// @tparam Base  The augmentation kept along with aggregates.
+///
+/// @note  Values of the tree should be changed only through its modify()
+///        method, otherwise aggregates get stale.
+template <class Monoid, class Base = NoAugmentation>
+struct Aggregate : Base {
+  using MonoidType = Monoid;
+  using SummaryType = typename Monoid::value_type;
+
+  struct Data : Base::Data {
+    SummaryType Summary = Monoid::identity();
+  };
+
+  template <class NodeType> static void update(NodeType *Node) {
+    Base::update(Node);
+    Node->Summary = Monoid::combine(
+        Monoid::combine(summary(Node->Left), lift(Node)), summary(Node->Right));
+  }
+
+  template <class NodeType>
+  static SummaryType summary(const NodeType *Node) {
+    return Node != nullptr ? Node->Summary : Monoid::identity();
+  }
+
+  template <class NodeType> static SummaryType lift(const NodeType *Node) {
+    return Monoid::lift(Node->Key(), Node->Value());
+  }
+};
+
+template <class Augmentation, class = void>
+struct AggregatesValuesType : std::false_type {};
+
+template <class Augmentation>
+struct AggregatesValuesType<Augmentation,
+                            std::void_t<typename Augmentation::MonoidType>>
+    : std::true_type {};
+
+/// True if the augmentation keeps aggregates of sub-trees.
+template <class Augmentation>
+constexpr inline bool AggregatesValues =
+    AggregatesValuesType<Augmentation>::value;
+
+/// @brief Updates of values over ranges of keys are applied lazily.
+///
+/// An update of the whole sub-tree is applied to its root right away and is
+/// left pending for its children.  Pending updates go further down with
+/// searches and rotations passing through.
+///
+/// @tparam Update  Type describing updates of values:
+///                 - @c value_type is the type of updates;
+///                 - @c identity() is the update changing nothing, pending
+///                   updates are compared with it;
+///                 - @c compose(First, Second) is the update doing @c First
+///                   and then @c Second;
+///                 - @c apply(Update, Value) changes one value.
+/// @tparam Base  The augmentation kept along with updates.  If it aggregates
+///               values, it should count sub-trees as well, and @p Update
+///               should have @c apply(Update, Summary, Count) changing the
+///               aggregate of @c Count values.
+template <class Update, class Base = NoAugmentation> struct Lazy : Base {
+  using UpdateType = Update;
+  using PendingType = typename Update::value_type;
+
+  struct Data : Base::Data {
+    PendingType Pending = Update::identity();
+  };
+
+  /// Apply the update to the whole sub-tree (which can be empty).
+  template <class NodeType>
+  static void apply(NodeType *Node, const PendingType &ToApply) {
+    if (Node == nullptr) {
+      return;
+    }
+    Update::apply(ToApply, Node->Value());
+    if constexpr (AggregatesValues<Base>) {
+      static_assert(CountsSubtrees<Base>,
+                    "updates of aggregates need sizes of sub-trees");
+      Update::apply(ToApply, Node->Summary, Node->SubtreeSize);
+    }
+    Node->Pending = Update::compose(Node->Pending, ToApply);
+  }
+
+  /// Pass the pending update of the node to its children.
+  template <class NodeType> static void push(NodeType *Node) {
+    if (Node->Pending == Update::identity()) {
+      return;
+    }
+    apply(Node->Left, Node->Pending);
+    apply(Node->Right, Node->Pending);
+    Node->Pending = Update::identity();
+  }
+};
+
+template <class Augmentation, class = void>
+struct UpdatesLazilyType : std::false_type {};
+
+template <class Augmentation>
+struct UpdatesLazilyType<Augmentation,
+                         std::void_t<typename Augmentation::UpdateType>>
+    : std::true_type {};
+
+/// True if the augmentation applies updates lazily.
+template <class Augmentation>
+constexpr inline bool UpdatesLazily = UpdatesLazilyType<Augmentation>::value;
+
+/// @brief Sum of values.
+template <class T> struct Sum {
+  using value_type = T;
+
+  static T identity() { return T{}; }
+  static T combine(const T &LHS, const T &RHS) { return LHS + RHS; }
+  template <class KeyType, class ValueType>
+  static T lift(const KeyType &, const ValueType &Value) {
+    return static_cast<T>(Value);
+  }
+};
+
+/// @brief Minimum of values.
+template <class T> struct Min {
+  using value_type = T;
+
+  static T identity() { return std::numeric_limits<T>::max(); }
+  static T combine(const T &LHS, const T &RHS) { return std::min(LHS, RHS); }
+  template <class KeyType, class ValueType>
+  static T lift(const KeyType &, const ValueType &Value) {
+    return static_cast<T>(Value);
+  }
+};
+
+/// @brief Maximum of values.
+template <class T> struct Max {
+  using value_type = T;
+
+  static T identity() { return std::numeric_limits<T>::lowest(); }
+  static T combine(const T &LHS, const T &RHS) { return std::max(LHS, RHS); }
+  template <class KeyType, class ValueType>
+  static T lift(const KeyType &, const ValueType &Value) {
+    return static_cast<T>(Value);
+  }
+};
+
+/// @brief Adding a constant to values.
+///
+/// Aggregates, if any, are assumed to be sums.
+template <class T> struct Add {
+  using value_type = T;
+
+  static T identity() { return T{}; }
+  static T compose(const T &First, const T &Second) { return First + Second; }
+  template <class ValueType>
+  static void apply(const T &Delta, ValueType &Value) {
+    Value += Delta;
+  }
+  template <class SummaryType>
+  static void apply(const T &Delta, SummaryType &Summary, std::size_t Count) {
+    Summary += Delta * static_cast<SummaryType>(Count);
+  }
+};
+
+} // end namespace hammock::policy
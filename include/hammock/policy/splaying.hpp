@@ -0,0 +1,151 @@
+#pragma once
+
+#include "hammock/utils/rotation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace hammock::policy {
+
+/// @brief Classic bottom-up splaying.
+///
+/// The tree is searched first and then the accessed node is rotated all the
+/// way up to the root following the parent pointers.
+struct BottomUp {
+  static constexpr bool IsTopDown = false;
+
+  template <class NodeType> void operator()(NodeType *Accessed) const {
+    utils::splay(Accessed);
+  }
+};
+
+/// @brief Top-down splaying (Sleator & Tarjan).
+///
+/// The tree is split into the left and right parts while it is being searched
+/// and then reassembled around the accessed node.  It takes a single pass
+/// from the root down instead of a pass down and another pass up.
+struct TopDown {
+  static constexpr bool IsTopDown = true;
+};
+
+/// @brief Bottom-up splaying of only a random fraction of accesses.
+///
+/// Rotations dirty several cache lines each, and when the access pattern is
+/// only mildly skewed, splaying on every access costs more than it saves.
+class Probabilistic {
+public:
+  static constexpr bool IsTopDown = false;
+
+  /// @param Probability  Probability of splaying on each access.
+  explicit Probabilistic(double Probability = 0.5)
+      : Threshold(static_cast<std::uint64_t>(Probability * (1ull << 32))) {}
+
+  template <class NodeType> void operator()(NodeType *Accessed) {
+    // xorshift32 is good enough for coin flips
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    if (State < Threshold) {
+      utils::splay(Accessed);
+    }
+  }
+
+private:
+  std::uint64_t Threshold;
+  std::uint32_t State = 0x9e3779b9;
+};
+
+/// @brief Semi-splaying (Sleator & Tarjan).
+///
+/// See @ref utils::semiSplay.
+struct SemiSplay {
+  static constexpr bool IsTopDown = false;
+
+  template <class NodeType> void operator()(NodeType *Accessed) const {
+    utils::semiSplay(Accessed);
+  }
+};
+
+/// @brief Bottom-up splaying of only the nodes deeper than the threshold.
+///
+/// Nodes that are close enough to the root are left where they are, so
+/// the hot set stops moving around once it has settled near the top.
+class DepthThreshold {
+public:
+  static constexpr bool IsTopDown = false;
+
+  explicit DepthThreshold(std::size_t Threshold = 16) : Threshold(Threshold) {}
+
+  template <class NodeType> void operator()(NodeType *Accessed) const {
+    // The path was just walked down, so walking it up again is cheap
+    std::size_t Depth = 0;
+    for (auto *Current = Accessed; not Current->isRoot() and
+                                   Depth <= Threshold;
+         Current = Current->Parent) {
+      ++Depth;
+    }
+    if (Depth > Threshold) {
+      utils::splay(Accessed);
+    }
+  }
+
+private:
+  std::size_t Threshold;
+};
+
+/// @brief Bottom-up splaying of every N-th access.
+///
+/// It is a deterministic counterpart of @ref Probabilistic.
+class Counter {
+public:
+  static constexpr bool IsTopDown = false;
+
+  explicit Counter(std::size_t Period = 2) : Period(Period) {}
+
+  template <class NodeType> void operator()(NodeType *Accessed) {
+    if (++Accesses == Period) {
+      Accesses = 0;
+      utils::splay(Accessed);
+    }
+  }
+
+private:
+  std::size_t Period, Accesses = 0;
+};
+
+/// @brief Policy that splays just like @tp Base does and counts hits and
+/// misses of find() on top of that.
+///
+/// The tree exposes its policy through get_splay_policy().
+template <class Base> class WithStatistics : public Base {
+public:
+  using Base::Base;
+
+  void recordLookup(bool Hit) { ++(Hit ? Hits : Misses); }
+
+  std::size_t hits() const { return Hits; }
+  std::size_t misses() const { return Misses; }
+  std::size_t lookups() const { return Hits + Misses; }
+
+  void reset() { Hits = Misses = 0; }
+
+private:
+  std::size_t Hits = 0, Misses = 0;
+};
+
+template <class Policy, class = void>
+struct RecordsLookupsType : std::false_type {};
+
+template <class Policy>
+struct RecordsLookupsType<Policy,
+                          std::void_t<decltype(std::declval<Policy &>()
+                                                   .recordLookup(true))>>
+    : std::true_type {};
+
+/// True if the policy wants to know the outcome of every lookup.
+template <class Policy>
+constexpr inline bool RecordsLookups = RecordsLookupsType<Policy>::value;
+
+} // end namespace hammock::policy
@@ -1,15 +1,510 @@
 #pragma once
 
 #include "hammock/impl/splay.hpp"
-#include "hammock/utils/traversal.hpp"
+#include "hammock/tags.hpp"
 
-#include <map>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace hammock {
-template <class KeyType, class ValueType> class SplayTree {
+/// @brief Ordered associative container with the interface of std::map.
+///
+/// Recently accessed keys move towards the root, so that skewed workloads
+/// get cheaper lookups than with a balanced tree.  The container is meant
+/// to replace std::map by changing one type alias.
+///
+/// Differences from std::map:
+///   - lookups through a non-const container restructure the tree, so they
+///     are not safe to run concurrently even if nothing is modified (const
+///     lookups don't splay);
+///   - iterators stay valid until their elements are erased, just like with
+///     std::map, but the complexity guarantees are amortized.
+///
+/// @tparam SplayPolicy  When and how the tree is splayed, see
+///                      hammock/policy/splaying.hpp.
+template <class KeyType, class ValueType, class Compare = std::less<KeyType>,
+          class AllocatorType =
+              std::allocator<std::pair<const KeyType, ValueType>>,
+          class SplayPolicy = policy::BottomUp>
+class SplayTree {
+  using Implementation =
+      impl::SplayTree<KeyType, ValueType, Compare, AllocatorType, SplayPolicy>;
+
 public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<const KeyType, ValueType>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using key_compare = Compare;
+  using allocator_type = AllocatorType;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using pointer = typename std::allocator_traits<AllocatorType>::pointer;
+  using const_pointer =
+      typename std::allocator_traits<AllocatorType>::const_pointer;
+
+  using iterator = typename Implementation::iterator;
+  using const_iterator = typename Implementation::const_iterator;
+  using reverse_iterator = typename Implementation::reverse_iterator;
+  using const_reverse_iterator =
+      typename Implementation::const_reverse_iterator;
+
+  using node_type = typename Implementation::node_type;
+  using insert_return_type = typename Implementation::insert_return_type;
+
+  using splay_policy = SplayPolicy;
+
+  /// @brief Function object comparing key-value pairs by their keys.
+  class value_compare {
+  public:
+    bool operator()(const value_type &LHS, const value_type &RHS) const {
+      return Comparator(LHS.first, RHS.first);
+    }
+
+  protected:
+    friend class SplayTree;
+    value_compare(Compare Comparator) : Comparator(Comparator) {}
+
+    Compare Comparator;
+  };
+
+  SplayTree() = default;
+
+  explicit SplayTree(const Compare &Comparator,
+                     const AllocatorType &Allocator = AllocatorType())
+      : Impl(Comparator, Allocator) {}
+
+  explicit SplayTree(const AllocatorType &Allocator) : Impl(Allocator) {}
+
+  /// @brief Construct an empty tree with the configured splaying policy.
+  explicit SplayTree(const SplayPolicy &Policy) : Impl(Policy) {}
+
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  SplayTree(InputIterator First, InputIterator Last,
+            const Compare &Comparator = Compare(),
+            const AllocatorType &Allocator = AllocatorType())
+      : Impl(Comparator, Allocator) {
+    Impl.assign(First, Last);
+  }
+
+  /// @brief Construct the tree out of the sorted range in linear time.
+  ///
+  /// @pre  Keys in the range are sorted and unique.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  SplayTree(sorted_unique_t, InputIterator First, InputIterator Last,
+            const Compare &Comparator = Compare(),
+            const AllocatorType &Allocator = AllocatorType())
+      : Impl(Comparator, Allocator) {
+    Impl.assign(sorted_unique, First, Last);
+  }
+
+  SplayTree(std::initializer_list<value_type> Initializer,
+            const Compare &Comparator = Compare(),
+            const AllocatorType &Allocator = AllocatorType())
+      : SplayTree(Initializer.begin(), Initializer.end(), Comparator,
+                  Allocator) {}
+
+  SplayTree(const SplayTree &) = default;
+  SplayTree(SplayTree &&) = default;
+  SplayTree &operator=(const SplayTree &) = default;
+  SplayTree &operator=(SplayTree &&) = default;
+
+  SplayTree &operator=(std::initializer_list<value_type> Initializer) {
+    Impl.assign(Initializer.begin(), Initializer.end());
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return Impl.get_allocator(); }
+
+  mapped_type &at(const key_type &Key) { return Impl.at(Key); }
+  const mapped_type &at(const key_type &Key) const { return Impl.at(Key); }
+
+  mapped_type &operator[](const key_type &Key) {
+    return Impl.try_emplace(Key).first->second;
+  }
+  mapped_type &operator[](key_type &&Key) {
+    return Impl.try_emplace(std::move(Key)).first->second;
+  }
+
+  iterator begin() noexcept { return Impl.begin(); }
+  const_iterator begin() const noexcept { return Impl.begin(); }
+  const_iterator cbegin() const noexcept { return Impl.begin(); }
+
+  iterator end() noexcept { return Impl.end(); }
+  const_iterator end() const noexcept { return Impl.end(); }
+  const_iterator cend() const noexcept { return Impl.end(); }
+
+  reverse_iterator rbegin() noexcept { return Impl.rbegin(); }
+  const_reverse_iterator rbegin() const noexcept { return Impl.rbegin(); }
+  const_reverse_iterator crbegin() const noexcept { return Impl.rbegin(); }
+
+  reverse_iterator rend() noexcept { return Impl.rend(); }
+  const_reverse_iterator rend() const noexcept { return Impl.rend(); }
+  const_reverse_iterator crend() const noexcept { return Impl.rend(); }
+
+  [[nodiscard]] bool empty() const noexcept { return Impl.empty(); }
+  size_type size() const noexcept { return Impl.size(); }
+  size_type max_size() const noexcept {
+    return std::numeric_limits<difference_type>::max() /
+           sizeof(typename Implementation::Node);
+  }
+
+  void clear() noexcept { Impl.clear(); }
+
+  std::pair<iterator, bool> insert(const value_type &ToInsert) {
+    return Impl.insert(ToInsert);
+  }
+  std::pair<iterator, bool> insert(value_type &&ToInsert) {
+    return Impl.insert(std::move(ToInsert));
+  }
+  template <class PairType, class = std::enable_if_t<std::is_constructible_v<
+                                value_type, PairType &&>>>
+  std::pair<iterator, bool> insert(PairType &&ToInsert) {
+    return Impl.emplace(std::forward<PairType>(ToInsert));
+  }
+
+  /// @brief Insert the element right before or right after the hint.
+  ///
+  /// Accurate hints save the search from the root, appends with end() as
+  /// the hint take constant amortized time.
+  iterator insert(const_iterator Hint, const value_type &ToInsert) {
+    return Impl.insert(Hint, ToInsert);
+  }
+  iterator insert(const_iterator Hint, value_type &&ToInsert) {
+    return Impl.insert(Hint, std::move(ToInsert));
+  }
+  template <class PairType, class = std::enable_if_t<std::is_constructible_v<
+                                value_type, PairType &&>>>
+  iterator insert(const_iterator Hint, PairType &&ToInsert) {
+    return Impl.emplace_hint(Hint, std::forward<PairType>(ToInsert));
+  }
+
+  /// @brief Insert all of the key-value pairs from the range.
+  ///
+  /// If there are equivalent keys, only the first one of them is inserted.
+  template <class InputIterator, class = utils::IteratorCategory<InputIterator>>
+  void insert(InputIterator First, InputIterator Last) {
+    Impl.insert(First, Last);
+  }
+  void insert(std::initializer_list<value_type> Initializer) {
+    insert(Initializer.begin(), Initializer.end());
+  }
+
+  /// @brief Link the extracted node into the tree without reallocating it.
+  ///
+  /// If the key is already in the tree, the node stays with the handle.
+  insert_return_type insert(node_type &&Handle) {
+    return Impl.insert(std::move(Handle));
+  }
+  iterator insert(const_iterator Hint, node_type &&Handle) {
+    return Impl.insert(Hint, std::move(Handle));
+  }
+
+  template <class MappedType>
+  std::pair<iterator, bool> insert_or_assign(const key_type &Key,
+                                             MappedType &&Value) {
+    return assignIfFound(Impl.try_emplace(Key, std::forward<MappedType>(Value)),
+                         std::forward<MappedType>(Value));
+  }
+  template <class MappedType>
+  std::pair<iterator, bool> insert_or_assign(key_type &&Key,
+                                             MappedType &&Value) {
+    return assignIfFound(
+        Impl.try_emplace(std::move(Key), std::forward<MappedType>(Value)),
+        std::forward<MappedType>(Value));
+  }
+  template <class MappedType>
+  iterator insert_or_assign(const_iterator Hint, const key_type &Key,
+                            MappedType &&Value) {
+    return assignIfFound(
+               Impl.try_emplace(Hint, Key, std::forward<MappedType>(Value)),
+               std::forward<MappedType>(Value))
+        .first;
+  }
+  template <class MappedType>
+  iterator insert_or_assign(const_iterator Hint, key_type &&Key,
+                            MappedType &&Value) {
+    return assignIfFound(Impl.try_emplace(Hint, std::move(Key),
+                                          std::forward<MappedType>(Value)),
+                         std::forward<MappedType>(Value))
+        .first;
+  }
+
+  template <class... ArgsTypes>
+  std::pair<iterator, bool> emplace(ArgsTypes &&... Args) {
+    return Impl.emplace(std::forward<ArgsTypes>(Args)...);
+  }
+
+  template <class... ArgsTypes>
+  iterator emplace_hint(const_iterator Hint, ArgsTypes &&... Args) {
+    return Impl.emplace_hint(Hint, std::forward<ArgsTypes>(Args)...);
+  }
+
+  template <class... ArgsTypes>
+  std::pair<iterator, bool> try_emplace(const key_type &Key,
+                                        ArgsTypes &&... Args) {
+    return Impl.try_emplace(Key, std::forward<ArgsTypes>(Args)...);
+  }
+  template <class... ArgsTypes>
+  std::pair<iterator, bool> try_emplace(key_type &&Key, ArgsTypes &&... Args) {
+    return Impl.try_emplace(std::move(Key), std::forward<ArgsTypes>(Args)...);
+  }
+  template <class... ArgsTypes>
+  iterator try_emplace(const_iterator Hint, const key_type &Key,
+                       ArgsTypes &&... Args) {
+    return Impl.try_emplace(Hint, Key, std::forward<ArgsTypes>(Args)...).first;
+  }
+  template <class... ArgsTypes>
+  iterator try_emplace(const_iterator Hint, key_type &&Key,
+                       ArgsTypes &&... Args) {
+    return Impl
+        .try_emplace(Hint, std::move(Key), std::forward<ArgsTypes>(Args)...)
+        .first;
+  }
+
+  iterator erase(iterator Position) { return Impl.erase(Position); }
+  iterator erase(const_iterator Position) { return Impl.erase(Position); }
+
+  iterator erase(const_iterator First, const_iterator Last) {
+    return Impl.erase(First, Last);
+  }
+
+  /// @return  The number of erased elements (zero or one).
+  size_type erase(const key_type &Key) { return Impl.erase(Key); }
+
+  /// @brief Unlink the element and hand its node over to the caller.
+  node_type extract(const_iterator Position) { return Impl.extract(Position); }
+  node_type extract(const key_type &Key) { return Impl.extract(Key); }
+
+  void swap(SplayTree &Other) noexcept(
+      std::is_nothrow_swappable_v<Implementation>) {
+    using std::swap;
+    swap(Impl, Other.Impl);
+  }
+
+  /// @brief Move the elements with keys missing from this tree out of
+  /// @p Source.
+  ///
+  /// With equal allocators, nodes are relinked and nothing is reallocated.
+  template <class OtherCompare, class OtherPolicy>
+  void
+  merge(SplayTree<KeyType, ValueType, OtherCompare, AllocatorType, OtherPolicy>
+            &Source) {
+    Impl.merge(Source.Impl);
+  }
+  template <class OtherCompare, class OtherPolicy>
+  void
+  merge(SplayTree<KeyType, ValueType, OtherCompare, AllocatorType, OtherPolicy>
+            &&Source) {
+    merge(Source);
+  }
+
+  size_type count(const key_type &Key) { return Impl.count(Key); }
+  size_type count(const key_type &Key) const { return Impl.count(Key); }
+
+  iterator find(const key_type &Key) { return Impl.find(Key); }
+  const_iterator find(const key_type &Key) const { return Impl.find(Key); }
+
+  bool contains(const key_type &Key) { return Impl.contains(Key); }
+  bool contains(const key_type &Key) const { return Impl.contains(Key); }
+
+  std::pair<iterator, iterator> equal_range(const key_type &Key) {
+    return Impl.equal_range(Key);
+  }
+  std::pair<const_iterator, const_iterator>
+  equal_range(const key_type &Key) const {
+    return Impl.equal_range(Key);
+  }
+
+  iterator lower_bound(const key_type &Key) { return Impl.lower_bound(Key); }
+  const_iterator lower_bound(const key_type &Key) const {
+    return Impl.lower_bound(Key);
+  }
+
+  iterator upper_bound(const key_type &Key) { return Impl.upper_bound(Key); }
+  const_iterator upper_bound(const key_type &Key) const {
+    return Impl.upper_bound(Key);
+  }
+
+  /// @brief Lookups by keys of other types, which are available with
+  /// transparent comparators like std::less<>.
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  size_type count(const KeyLike &Key) {
+    return Impl.count(Key);
+  }
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  size_type count(const KeyLike &Key) const {
+    return Impl.count(Key);
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  iterator find(const KeyLike &Key) {
+    return Impl.find(Key);
+  }
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  const_iterator find(const KeyLike &Key) const {
+    return Impl.find(Key);
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  bool contains(const KeyLike &Key) {
+    return Impl.contains(Key);
+  }
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  bool contains(const KeyLike &Key) const {
+    return Impl.contains(Key);
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const KeyLike &Key) {
+    return Impl.equal_range(Key);
+  }
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  std::pair<const_iterator, const_iterator>
+  equal_range(const KeyLike &Key) const {
+    return Impl.equal_range(Key);
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  iterator lower_bound(const KeyLike &Key) {
+    return Impl.lower_bound(Key);
+  }
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  const_iterator lower_bound(const KeyLike &Key) const {
+    return Impl.lower_bound(Key);
+  }
+
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  iterator upper_bound(const KeyLike &Key) {
+    return Impl.upper_bound(Key);
+  }
+  template <class KeyLike, class C = Compare,
+            class = typename C::is_transparent>
+  const_iterator upper_bound(const KeyLike &Key) const {
+    return Impl.upper_bound(Key);
+  }
+
+  /// @brief Call @p Visitor with every element of [@p First, @p Last) in
+  /// order, faster than iterating over them.
+  template <class VisitorType>
+  void for_each(const_iterator First, const_iterator Last,
+                VisitorType Visitor) const {
+    Impl.for_each(First, Last, std::move(Visitor));
+  }
+  template <class VisitorType> void for_each(VisitorType Visitor) const {
+    Impl.for_each(std::move(Visitor));
+  }
+
+  /// @brief Put pointers to at most @p Capacity elements, starting from
+  /// @p From, into the buffer and move @p From past them.
+  ///
+  /// @return  The number of elements put into the buffer.
+  size_type gather(const_iterator &From, const_iterator Last,
+                   const value_type **Buffer, size_type Capacity) const {
+    return Impl.gather(From, Last, Buffer, Capacity);
+  }
+
+  key_compare key_comp() const { return Impl.key_comp(); }
+  value_compare value_comp() const { return value_compare(key_comp()); }
+
+  const splay_policy &get_splay_policy() const {
+    return Impl.get_splay_policy();
+  }
+
 private:
-  impl::SplayTree<KeyType, ValueType> Impl;
+  /// Finish insert_or_assign after try_emplace, which doesn't touch the
+  /// value if it finds the key.
+  template <class MappedType>
+  static std::pair<iterator, bool>
+  assignIfFound(std::pair<iterator, bool> Result, MappedType &&Value) {
+    if (not Result.second) {
+      Result.first->second = std::forward<MappedType>(Value);
+    }
+    return Result;
+  }
+
+  template <class, class, class, class, class> friend class SplayTree;
+
+  Implementation Impl;
 };
+
+// Comparisons go through the const interface, so they never splay.
+
+template <class K, class V, class C, class A, class P>
+bool operator==(const SplayTree<K, V, C, A, P> &LHS,
+                const SplayTree<K, V, C, A, P> &RHS) {
+  return LHS.size() == RHS.size() and
+         std::equal(LHS.begin(), LHS.end(), RHS.begin());
+}
+
+template <class K, class V, class C, class A, class P>
+bool operator!=(const SplayTree<K, V, C, A, P> &LHS,
+                const SplayTree<K, V, C, A, P> &RHS) {
+  return not(LHS == RHS);
+}
+
+template <class K, class V, class C, class A, class P>
+bool operator<(const SplayTree<K, V, C, A, P> &LHS,
+               const SplayTree<K, V, C, A, P> &RHS) {
+  return std::lexicographical_compare(LHS.begin(), LHS.end(), RHS.begin(),
+                                      RHS.end());
+}
+
+template <class K, class V, class C, class A, class P>
+bool operator>(const SplayTree<K, V, C, A, P> &LHS,
+               const SplayTree<K, V, C, A, P> &RHS) {
+  return RHS < LHS;
+}
+
+template <class K, class V, class C, class A, class P>
+bool operator<=(const SplayTree<K, V, C, A, P> &LHS,
+                const SplayTree<K, V, C, A, P> &RHS) {
+  return not(RHS < LHS);
+}
+
+template <class K, class V, class C, class A, class P>
+bool operator>=(const SplayTree<K, V, C, A, P> &LHS,
+                const SplayTree<K, V, C, A, P> &RHS) {
+  return not(LHS < RHS);
+}
+
+template <class K, class V, class C, class A, class P>
+void swap(SplayTree<K, V, C, A, P> &LHS,
+          SplayTree<K, V, C, A, P> &RHS) noexcept(noexcept(LHS.swap(RHS))) {
+  LHS.swap(RHS);
+}
+
+/// @brief Erase all of the elements satisfying the predicate.
+///
+/// @return  The number of erased elements.
+template <class K, class V, class C, class A, class P, class Predicate>
+std::size_t erase_if(SplayTree<K, V, C, A, P> &Tree, Predicate ToErase) {
+  const auto OriginalSize = Tree.size();
+  for (auto It = Tree.begin(); It != Tree.end();) {
+    if (ToErase(*It)) {
+      It = Tree.erase(It);
+    } else {
+      ++It;
+    }
+  }
+  return OriginalSize - Tree.size();
+}
 } // end namespace hammock
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace hammock {
+/// @brief Tag telling that the input range is sorted according to the
+/// comparator of the container and has no equivalent keys.
+struct sorted_unique_t {
+  explicit sorted_unique_t() = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+} // end namespace hammock
@@ -3,7 +3,10 @@
 #include "hammock/utils/traversal.hpp"
 #include "hammock/utils/type_traits.hpp"
 
+#include <cassert>
 #include <iterator>
+#include <type_traits>
+#include <vector>
 
 namespace hammock::utils {
 
@@ -14,9 +17,15 @@ public:
   using Node = AddConst<typename Tree::Node, Const>;
   using NodeBase = AddConst<typename Node::Header, Const>;
 
+  constexpr Iterator() noexcept = default;
   constexpr Iterator(NodeBase *TreeNode) noexcept
       : CorrespondingNode(TreeNode) {}
 
+  /// Mutable iterators convert to constant ones, but not vice versa.
+  template <bool OtherConst, class = std::enable_if_t<Const and not OtherConst>>
+  constexpr Iterator(const Iterator<Tree, OtherConst, Order> &Other) noexcept
+      : CorrespondingNode(Other.CorrespondingNode) {}
+
   using KeyValuePair = typename Node::Pair;
   using value_type = AddConst<KeyValuePair, Const>;
   using reference = value_type &;
@@ -27,9 +36,10 @@ public:
 
   constexpr pointer operator->() const { return &getNode()->KeyValuePair(); }
 
-  constexpr reference operator*() { return getNode()->KeyValuePair(); }
+  constexpr reference operator*() const { return getNode()->KeyValuePair(); }
 
   constexpr Iterator operator++() {
+    pushTowards<Direction::Right>();
     CorrespondingNode = successor<Direction::Right, Order>(CorrespondingNode);
     return *this;
   }
@@ -41,6 +51,7 @@ public:
   }
 
   constexpr Iterator operator--() {
+    pushTowards<Direction::Left>();
     CorrespondingNode = successor<Direction::Left, Order>(CorrespondingNode);
     return *this;
   }
@@ -51,20 +62,146 @@ public:
     return Copy;
   }
 
-  constexpr bool operator==(const Iterator &RHS) const {
-    return CorrespondingNode == RHS.CorrespondingNode;
+  // Non-members, so that mutable and constant iterators can be compared
+  // both ways.
+  friend constexpr bool operator==(const Iterator &LHS, const Iterator &RHS) {
+    return LHS.CorrespondingNode == RHS.CorrespondingNode;
   }
 
-  constexpr bool operator!=(const Iterator &RHS) const {
-    return !(*this == RHS);
+  friend constexpr bool operator!=(const Iterator &LHS, const Iterator &RHS) {
+    return !(LHS == RHS);
   }
 
 private:
   friend Tree;
+  template <class, bool, TraversalKind> friend class Iterator;
 
   Node *getNode() const { return CorrespondingNode->getRealNode(); }
 
-  NodeBase *CorrespondingNode;
+  /// Push pending updates down the path to the in-order successor from the
+  /// given direction, if it is below the current node.  Ancestors already
+  /// have their updates pushed, as they were on the way to this node.
+  template <Direction To> void pushTowards() {
+    if constexpr (not Const and Order == TraversalKind::InOrder and
+                  HasLazyUpdates<Node>) {
+      Node *Current = nullptr;
+      if (CorrespondingNode->isHeader()) {
+        // Going back from the end starts at the root
+        Current = CorrespondingNode->Parent == nullptr
+                      ? nullptr
+                      : CorrespondingNode->Parent->getRealNode();
+      } else {
+        pushAugmentation(getNode());
+        Current = getChild<To>(getNode());
+      }
+      for (; Current != nullptr; Current = getChild<invert(To)>(Current)) {
+        pushAugmentation(Current);
+      }
+    }
+  }
+
+  NodeBase *CorrespondingNode = nullptr;
+};
+
+/// @brief In-order iterator for trees without parent pointers.
+///
+/// It keeps the path from the root to the current node, so it is as big as
+/// the depth of the tree.  Any restructuring of the tree invalidates it.
+template <class Tree, bool Const = false> class StackIterator {
+public:
+  using Node = AddConst<typename Tree::Node, Const>;
+  using Path = std::vector<Node *>;
+
+  StackIterator(Node *const *Root, Path Ancestors = {})
+      : Root(Root), Ancestors(std::move(Ancestors)) {}
+
+  using KeyValuePair = typename Node::Pair;
+  using value_type = AddConst<KeyValuePair, Const>;
+  using reference = value_type &;
+  using pointer = value_type *;
+
+  using iterator_category = std::bidirectional_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+
+  pointer operator->() const { return &getNode()->KeyValuePair(); }
+
+  reference operator*() const { return getNode()->KeyValuePair(); }
+
+  StackIterator &operator++() {
+    step<Direction::Right>();
+    return *this;
+  }
+
+  StackIterator operator++(int) {
+    StackIterator Copy = *this;
+    operator++();
+    return Copy;
+  }
+
+  StackIterator &operator--() {
+    step<Direction::Left>();
+    return *this;
+  }
+
+  StackIterator operator--(int) {
+    StackIterator Copy = *this;
+    operator--();
+    return Copy;
+  }
+
+  bool operator==(const StackIterator &RHS) const {
+    return getNodeOrNull() == RHS.getNodeOrNull();
+  }
+
+  bool operator!=(const StackIterator &RHS) const { return !(*this == RHS); }
+
+private:
+  friend Tree;
+
+  Node *getNode() const {
+    assert(("End iterator should not be dereferenced" && not isEnd()));
+    return Ancestors.back();
+  }
+
+  Node *getNodeOrNull() const { return isEnd() ? nullptr : Ancestors.back(); }
+
+  bool isEnd() const { return Ancestors.empty(); }
+
+  /// Push the path from the given node to its outmost descendant.
+  template <Direction To> void descend(Node *From) {
+    for (; From != nullptr; From = getChild<To>(From)) {
+      Ancestors.push_back(From);
+    }
+  }
+
+  template <Direction To> void step() {
+    constexpr Direction From = invert(To);
+
+    // Stepping back from the end, we should start from the outmost node
+    if (isEnd()) {
+      if constexpr (To == Direction::Left) {
+        descend<Direction::Right>(*Root);
+      }
+      return;
+    }
+
+    // If there is a sub-tree in a direction of traversal, we should
+    // go there starting from the closest node...
+    if (auto *Child = getChild<To>(getNode())) {
+      descend<From>(Child);
+      return;
+    }
+
+    // ...otherwise we should go up until we come from the 'From' direction
+    Node *Visited = nullptr;
+    do {
+      Visited = Ancestors.back();
+      Ancestors.pop_back();
+    } while (not isEnd() and getChild<To>(Ancestors.back()) == Visited);
+  }
+
+  Node *const *Root;
+  Path Ancestors;
 };
 
 } // end namespace hammock::utils
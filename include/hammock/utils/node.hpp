@@ -1,6 +1,13 @@
 #pragma once
 
+#include "hammock/policy/augmentation.hpp"
+#include "hammock/utils/direction.hpp"
+#include "hammock/utils/type_traits.hpp"
+
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 
@@ -19,7 +26,7 @@ public:
 
   NodeBase() = default;
 
-  NodeBase(bool Header) noexcept : HeaderFlag(Header) {}
+  NodeBase(bool Header) noexcept : Left(Header ? tag(nullptr) : nullptr) {}
 
   // copying pointers from another tree is pointless
   // Derived class can have its own copy construction/assignment
@@ -29,7 +36,12 @@ public:
   NodeBase(NodeBase &&) noexcept = default;
   NodeBase &operator=(NodeBase &&) noexcept = default;
 
-  bool isHeader() const { return HeaderFlag; }
+  // Real nodes are at least pointer-aligned, so the lowest bit of a pointer
+  // to a real node is always zero.  The header marks itself by setting this
+  // bit in its pointer to the leftmost node.
+  bool isHeader() const {
+    return reinterpret_cast<std::uintptr_t>(Left) & HeaderTag;
+  }
   bool isRoot() const { return Parent->isHeader(); }
   bool isSpecial() const { return Parent->Parent == this; }
 
@@ -43,17 +55,53 @@ public:
     return Parent == nullptr ? nullptr : Parent->getRealNode();
   }
 
+  /// @brief Get the left/rightmost node of the tree.
+  ///
+  /// @pre  This node is the header.
+  template <Direction Which> Derived *getShortcut() const {
+    assert(("Only header has shortcuts" && isHeader()));
+    if constexpr (Which == Direction::Left) {
+      return untag(Left);
+    } else {
+      return Right;
+    }
+  }
+
+  /// @brief Set the left/rightmost node of the tree.
+  ///
+  /// @pre  This node is the header.
+  template <Direction Which> void setShortcut(Derived *Shortcut) {
+    assert(("Only header has shortcuts" && isHeader()));
+    if constexpr (Which == Direction::Left) {
+      Left = tag(Shortcut);
+    } else {
+      Right = Shortcut;
+    }
+  }
+
   NodeBase *Parent = nullptr;
+  // For the header, Left is the tagged pointer to the leftmost node and
+  // it should be accessed only through shortcut getters and setters.
   Derived *Left = nullptr, *Right = nullptr;
 
 private:
-  // TODO: figure out how to avoid having this extra bit of information
-  bool HeaderFlag = false;
+  static constexpr std::uintptr_t HeaderTag = 1;
+
+  static Derived *tag(Derived *Pointer) {
+    return reinterpret_cast<Derived *>(
+        reinterpret_cast<std::uintptr_t>(Pointer) | HeaderTag);
+  }
+
+  static Derived *untag(Derived *Pointer) {
+    return reinterpret_cast<Derived *>(
+        reinterpret_cast<std::uintptr_t>(Pointer) & ~HeaderTag);
+  }
 };
 
-template <class KeyTypeT, class ValueTypeT>
-struct Node : public NodeBase<Node<KeyTypeT, ValueTypeT>> {
-  using Header = NodeBase<Node>;
+/// @brief Storage for the key-value pair of a node.
+///
+/// The pair is constructed and destroyed by the tree, which owns the node.
+template <class KeyTypeT, class ValueTypeT> struct Payload {
   using KeyType = KeyTypeT;
   using ValueType = ValueTypeT;
   using Pair = std::pair<const KeyType, ValueType>;
@@ -74,4 +122,59 @@ struct Node : public NodeBase<Node<KeyTypeT, ValueTypeT>> {
   std::aligned_storage_t<sizeof(Pair), alignof(Pair)> KeyValueBuffer;
 };
 
+/// @brief Node with a pointer to its parent.
+///
+/// @tparam AugmentationT  The policy for the data every node keeps about its
+///                        sub-tree, see @ref policy::NoAugmentation.
+template <class KeyTypeT, class ValueTypeT,
+          class AugmentationT = policy::NoAugmentation>
+struct Node : public NodeBase<Node<KeyTypeT, ValueTypeT, AugmentationT>>,
+              public Payload<KeyTypeT, ValueTypeT>,
+              public AugmentationT::Data {
+  using Header = NodeBase<Node>;
+  using Augmentation = AugmentationT;
+};
+
+/// @brief Pass the pending update of the node down to its children.
+///
+/// @note  It is a no-op for nodes without lazy updates and for const nodes,
+///        which are only read.
+template <class NodeType>
+constexpr inline void pushAugmentation(NodeType *Node) {
+  if constexpr (HasLazyUpdates<NodeType> and not std::is_const_v<NodeType>) {
+    NodeType::Augmentation::push(Node);
+  }
+}
+
+/// @brief Recompute the augmentation data of the node from its children.
+///
+/// @note  It is a no-op for nodes without augmentation.
+template <class NodeType>
+constexpr inline void updateAugmentation(NodeType *Node) {
+  if constexpr (HasAugmentation<NodeType>) {
+    NodeType::Augmentation::update(Node);
+  }
+}
+
+/// @brief Node without a pointer to its parent.
+///
+/// It costs only two pointers on top of the key-value pair, but the tree
+/// can be traversed only from the root down.
+template <class KeyTypeT, class ValueTypeT>
+struct CompactNode : public Payload<KeyTypeT, ValueTypeT> {
+  CompactNode *Left = nullptr, *Right = nullptr;
+};
+
+/// @brief Node without a pointer to its parent that can belong to several
+/// trees at once.
+///
+/// @c References is the number of links to the node: from parents in all
+/// of the trees and from the roots.  A node with a single reference belongs
+/// to exactly one tree and can be changed in place, others are immutable.
+template <class KeyTypeT, class ValueTypeT>
+struct SharedNode : public Payload<KeyTypeT, ValueTypeT> {
+  SharedNode *Left = nullptr, *Right = nullptr;
+  std::atomic<std::size_t> References{1};
+};
+
 } // end namespace hammock::utils
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace hammock::utils {
+
+/// @brief Memory arena that hands out slots of the same size.
+///
+/// Slots are carved out of chunks, which grow geometrically.  Freed slots
+/// are kept in a free list and reused before anything else, so that the
+/// memory of one tree stays as compact as possible.
+///
+/// The size of slots is fixed by the first call to @ref configure.
+///
+/// @note  Arena is not thread-safe.
+class Arena {
+public:
+  Arena() noexcept = default;
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  ~Arena() noexcept { release(); }
+
+  /// @brief Check if the arena serves objects of the given size and alignment.
+  ///
+  /// @return  True if the arena serves the objects of this kind.  It is
+  ///          always true for the first call, which fixes the slot size.
+  bool configure(std::size_t Size, std::size_t Alignment) noexcept {
+    Size = std::max(Size, sizeof(FreeSlot));
+    Alignment = std::max(Alignment, alignof(FreeSlot));
+    Size = (Size + Alignment - 1) / Alignment * Alignment;
+
+    if (SlotSize == 0) {
+      SlotSize = Size;
+      SlotAlignment = Alignment;
+    }
+    return SlotSize == Size and SlotAlignment == Alignment;
+  }
+
+  /// @pre  The arena is configured.
+  [[nodiscard]] void *allocate() {
+    assert(("Arena should be configured first" && SlotSize != 0));
+    ++Allocated;
+
+    if (FreeList != nullptr and Reserved == 0) {
+      return std::exchange(FreeList, FreeList->Next);
+    }
+
+    if (Cursor == End) {
+      grow(0);
+    }
+
+    Reserved -= Reserved != 0;
+    return std::exchange(Cursor, Cursor + SlotSize);
+  }
+
+  /// @pre  @p Slot was allocated by this arena.
+  void deallocate(void *Slot) noexcept {
+    --Allocated;
+    FreeList = ::new (Slot) FreeSlot{FreeList};
+  }
+
+  /// @brief Make sure that the next @p NumberOfSlots allocations are served
+  /// from one contiguous block of memory.
+  ///
+  /// @pre  The arena is configured.
+  void reserve(std::size_t NumberOfSlots) {
+    assert(("Arena should be configured first" && SlotSize != 0));
+    if (capacity() < NumberOfSlots) {
+      grow(NumberOfSlots);
+    }
+    Reserved = NumberOfSlots;
+  }
+
+  /// @brief Free all the memory of the arena at once.
+  ///
+  /// @pre  Nothing allocated from this arena is ever used afterwards.
+  void release() noexcept {
+    for (auto [Chunk, Size] : Chunks) {
+      ::operator delete(Chunk, Size, std::align_val_t{SlotAlignment});
+    }
+    Chunks.clear();
+    FreeList = nullptr;
+    Cursor = End = nullptr;
+    Allocated = Reserved = 0;
+  }
+
+  /// @brief Get the number of slots currently in use.
+  std::size_t allocated() const noexcept { return Allocated; }
+
+private:
+  struct FreeSlot {
+    FreeSlot *Next;
+  };
+
+  std::size_t capacity() const { return (End - Cursor) / SlotSize; }
+
+  void grow(std::size_t AtLeast) {
+    // Whatever is left in the current chunk is not lost
+    for (; Cursor != End; Cursor += SlotSize) {
+      FreeList = ::new (Cursor) FreeSlot{FreeList};
+    }
+
+    NextChunkSlots = std::max(AtLeast, NextChunkSlots);
+    const std::size_t Size = NextChunkSlots * SlotSize;
+    Cursor = static_cast<std::byte *>(
+        ::operator new(Size, std::align_val_t{SlotAlignment}));
+    End = Cursor + Size;
+    Chunks.emplace_back(Cursor, Size);
+
+    NextChunkSlots = std::min(NextChunkSlots * 2, MaxChunkSlots);
+  }
+
+  static constexpr std::size_t MinChunkSlots = 64;
+  static constexpr std::size_t MaxChunkSlots = 64 * 1024;
+
+  std::size_t SlotSize = 0, SlotAlignment = 0;
+  std::size_t NextChunkSlots = MinChunkSlots;
+  std::size_t Allocated = 0, Reserved = 0;
+
+  FreeSlot *FreeList = nullptr;
+  std::byte *Cursor = nullptr, *End = nullptr;
+  std::vector<std::pair<void *, std::size_t>> Chunks;
+};
+
+/// @brief Allocator for tree nodes backed by an arena.
+///
+/// Copies (and rebound copies) of the allocator share the arena.  Copies of
+/// containers, however, get their own arena.  Only single objects of the
+/// type the arena was configured for are served from the arena, everything
+/// else goes to the global operator new.
+template <class T> class PoolAllocator {
+public:
+  using value_type = T;
+
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  PoolAllocator() : Storage(std::make_shared<Arena>()) {}
+
+  template <class U>
+  PoolAllocator(const PoolAllocator<U> &Other) noexcept
+      : Storage(Other.Storage) {}
+
+  [[nodiscard]] T *allocate(std::size_t N) {
+    if (N == 1 and Storage->configure(sizeof(T), alignof(T))) {
+      return static_cast<T *>(Storage->allocate());
+    }
+    return static_cast<T *>(
+        ::operator new(N * sizeof(T), std::align_val_t{alignof(T)}));
+  }
+
+  void deallocate(T *Pointer, std::size_t N) noexcept {
+    if (N == 1 and Storage->configure(sizeof(T), alignof(T))) {
+      Storage->deallocate(Pointer);
+      return;
+    }
+    ::operator delete(Pointer, N * sizeof(T), std::align_val_t{alignof(T)});
+  }
+
+  /// @brief Make sure that the next @p N allocations of single objects are
+  /// served from one contiguous block of memory.
+  void reserve(std::size_t N) {
+    if (Storage->configure(sizeof(T), alignof(T))) {
+      Storage->reserve(N);
+    }
+  }
+
+  /// @brief Free all the memory allocated by this allocator and its copies.
+  ///
+  /// @pre  Nothing allocated by this allocator is ever used afterwards.
+  void release() noexcept { Storage->release(); }
+
+  /// @brief Get the number of objects allocated from the arena and not yet
+  /// deallocated.
+  std::size_t allocated() const noexcept { return Storage->allocated(); }
+
+  PoolAllocator select_on_container_copy_construction() const { return {}; }
+
+  template <class U>
+  bool operator==(const PoolAllocator<U> &Other) const noexcept {
+    return Storage == Other.Storage;
+  }
+
+  template <class U>
+  bool operator!=(const PoolAllocator<U> &Other) const noexcept {
+    return !(*this == Other);
+  }
+
+private:
+  template <class U> friend class PoolAllocator;
+
+  std::shared_ptr<Arena> Storage;
+};
+
+} // end namespace hammock::utils
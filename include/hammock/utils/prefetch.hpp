@@ -0,0 +1,12 @@
+#pragma once
+
+namespace hammock::utils {
+/// @brief Hint the CPU that the given memory is going to be read soon.
+///
+/// It is a no-op on compilers without the corresponding builtin.
+inline void prefetch([[maybe_unused]] const void *Address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(Address, 0, 3);
+#endif
+}
+} // end namespace hammock::utils
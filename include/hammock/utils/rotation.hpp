@@ -4,6 +4,7 @@
 #include "hammock/utils/traversal.hpp"
 
 #include <cassert>
+#include <initializer_list>
 
 namespace hammock::utils {
 template <Direction To, class NodeType>
@@ -16,6 +17,11 @@ constexpr inline NodeType *rotate(NodeType *Node) {
   if (not NewTop)
     return Node;
 
+  // Sub-trees change their parents, so their pending updates should be
+  // with them by then
+  pushAugmentation(Node->getRealNode());
+  pushAugmentation(NewTop);
+
   auto RelocatedChild = getChild<To>(NewTop);
   getChild<From>(Node) = RelocatedChild;
   getChild<To>(NewTop) = Node->getRealNode();
@@ -28,9 +34,16 @@ constexpr inline NodeType *rotate(NodeType *Node) {
 
   if (not Parent->isHeader()) {
     getParentLocation(Node) = NewTop;
+  } else {
+    // The header's parent is the root of the tree
+    Parent->Parent = NewTop;
   }
 
   Parent = NewTop;
+
+  // The old top is below the new one now
+  updateAugmentation(Node->getRealNode());
+  updateAugmentation(NewTop);
   return NewTop;
 }
 
@@ -68,4 +81,193 @@ template <class NodeType> constexpr inline void splay(NodeType *Node) {
     }
   }
 }
+
+/// @brief Semi-splay the node (Sleator & Tarjan).
+///
+/// Unlike full splaying, the zig-zig case rotates only the parent over the
+/// grandparent and continues from the parent.  The accessed node doesn't
+/// necessarily become the root, but the depth of the whole access path is
+/// roughly halved with half of the rotations.
+///
+/// @tparam NodeType  Type of the node.
+///
+/// @param Node  The accessed node.
+template <class NodeType> constexpr inline void semiSplay(NodeType *Node) {
+  while (not Node->isRoot()) {
+    auto *Parent = Node->Parent;
+    if (Parent->isRoot()) {
+      if (isChild<Direction::Left>(Node))
+        rotate<Direction::Right>(Parent);
+      else
+        rotate<Direction::Left>(Parent);
+      return;
+    }
+
+    const bool IsLeft = isChild<Direction::Left>(Node);
+    if (IsLeft == isChild<Direction::Left>(Parent)) {
+      // Zig-zig: the parent takes the place of the grandparent
+      if (IsLeft)
+        rotate<Direction::Right>(Parent->Parent);
+      else
+        rotate<Direction::Left>(Parent->Parent);
+      Node = Parent;
+
+    } else if (IsLeft) {
+      // Zig-zag: the node takes the place of the grandparent
+      rotate<Direction::Right>(Parent);
+      rotate<Direction::Left>(Node->Parent);
+    } else {
+      rotate<Direction::Left>(Parent);
+      rotate<Direction::Right>(Node->Parent);
+    }
+  }
+}
+
+/// @brief Attach the node to the outmost position of the partially built tree.
+///
+/// @tparam To  The outmost direction of the tree to attach the node to.
+/// @tparam NodeType  Type of the node.
+///
+/// @param ToLink  The node to attach.
+/// @param Top  The root of the tree to attach the node to, can be null.
+/// @param Tail  The current outmost node of that tree, can be null.
+///
+/// @note  This function makes sense only in the context of the @ref
+///        splayTopDown function.
+template <Direction To, class NodeType>
+constexpr inline void link(NodeType *ToLink, NodeType *&Top, NodeType *&Tail) {
+  if (Tail) {
+    getChild<To>(Tail) = ToLink;
+    setParent(ToLink, Tail);
+  } else {
+    Top = ToLink;
+  }
+  Tail = ToLink;
+}
+
+/// @brief Splay the tree by the given key in one pass from the root down.
+///
+/// @tparam NodeType  Type of the node.
+/// @tparam KeyType  Type of the key to search for.
+/// @tparam Compare  Type of the comparator function.
+///
+/// @param Root  The root of the tree (or a sub-tree) to splay.
+/// @param Key  The key to search for.
+/// @param Comparator  A comparator function for keys.
+///
+/// @return  The new root of the tree.  It is the node with the given @p Key
+///          if the tree has one, or the last node on the search path (i.e.
+///          the predecessor or the successor of the @p Key) otherwise.
+///
+/// @pre  @p Root is not null.
+///
+/// @post  The parent of the new root is the original parent of @p Root,
+///        it is the caller's responsibility to point that parent to the new
+///        root.
+///
+/// @note  Parent pointers are maintained only if @tp NodeType has them,
+///        the algorithm itself doesn't need them.
+template <class NodeType, class KeyType, class Compare>
+constexpr inline NodeType *splayTopDown(NodeType *Root, const KeyType &Key,
+                                        Compare &Comparator) {
+  assert(("The tree to splay should not be empty" && Root != nullptr));
+
+  // All nodes with keys less than the given key are collected in the left
+  // tree, and all the nodes with greater keys - in the right one.  We link
+  // new nodes to the rightmost position of the left tree and to the leftmost
+  // position of the right tree, tails are exactly these positions.
+  NodeType *LeftTop = nullptr, *LeftTail = nullptr;
+  NodeType *RightTop = nullptr, *RightTail = nullptr;
+
+  // We should remember the parent before it is overwritten
+  [[maybe_unused]] auto *Parent = [Root] {
+    if constexpr (HasParent<NodeType>) {
+      return Root->Parent;
+    } else {
+      return static_cast<NodeType *>(nullptr);
+    }
+  }();
+
+  auto *Top = Root;
+  for (;;) {
+    // Every node on the path is pushed before its children are touched
+    pushAugmentation(Top);
+    if (Comparator(Key, Top->Key())) {
+      auto *Child = Top->Left;
+      if (Child == nullptr)
+        break;
+
+      if (Comparator(Key, Child->Key())) {
+        pushAugmentation(Child);
+        // Zig-zig case, we should rotate first...
+        Top->Left = Child->Right;
+        setParent(Top->Left, Top);
+        Child->Right = Top;
+        setParent(Top, Child);
+        // This sub-tree doesn't change anymore
+        updateAugmentation(Top);
+        Top = Child;
+
+        if (Top->Left == nullptr)
+          break;
+      }
+      // ...and then make the top a part of the right tree
+      link<Direction::Left>(Top, RightTop, RightTail);
+      Top = Top->Left;
+
+    } else if (Comparator(Top->Key(), Key)) {
+      auto *Child = Top->Right;
+      if (Child == nullptr)
+        break;
+
+      if (Comparator(Child->Key(), Key)) {
+        pushAugmentation(Child);
+        Top->Right = Child->Left;
+        setParent(Top->Right, Top);
+        Child->Left = Top;
+        setParent(Top, Child);
+        updateAugmentation(Top);
+        Top = Child;
+
+        if (Top->Right == nullptr)
+          break;
+      }
+      link<Direction::Right>(Top, LeftTop, LeftTail);
+      Top = Top->Right;
+
+    } else {
+      break;
+    }
+  }
+
+  // Reassemble the tree: children of the top become the outmost children
+  // of the left and right trees, and these trees become children of the top.
+  if (LeftTail) {
+    LeftTail->Right = Top->Left;
+    setParent(Top->Left, LeftTail);
+    Top->Left = LeftTop;
+    setParent(LeftTop, Top);
+  }
+  if (RightTail) {
+    RightTail->Left = Top->Right;
+    setParent(Top->Right, RightTail);
+    Top->Right = RightTop;
+    setParent(RightTop, Top);
+  }
+
+  if constexpr (HasAugmentation<NodeType>) {
+    // Nodes on the inner spines of the left and right trees got new children,
+    // they are updated from the bottom up to the new top.
+    for (auto *Tail : {LeftTail, RightTail}) {
+      for (auto *Spine = Tail; Spine != nullptr and Spine != Top;
+           Spine = Spine->Parent->getRealNode()) {
+        updateAugmentation(Spine);
+      }
+    }
+  }
+  updateAugmentation(Top);
+
+  setParent(Top, Parent);
+  return Top;
+}
 } // end namespace hammock::utils
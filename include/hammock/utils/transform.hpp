@@ -3,37 +3,160 @@
 #include "hammock/utils/traversal.hpp"
 
 #include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
 
 namespace hammock::utils {
 
+/// @brief Exchange positions of two nodes in the tree.
+///
+/// @tparam NodeType  Type of the node.
+///
+/// @param LHS  The first node to swap.
+/// @param RHS  The second node to swap.
+///
+/// @pre  Neither @p LHS nor @p RHS is a header.
+///
+/// @note  Nodes can be adjacent, i.e. one can be a child of another.
 template <class NodeType>
 constexpr inline void swap(NodeType *LHS, NodeType *RHS) {
   assert(("Header nodes should never be swapped" && not LHS->isHeader()));
   assert(("Header nodes should never be swapped" && not RHS->isHeader()));
 
-  std::swap(LHS->Right, RHS->Right);
-  std::swap(LHS->Left, RHS->Left);
-  if (not LHS->isRoot()) {
-    getParentLocation(LHS) = RHS;
+  // We should figure out where both of the nodes are attached before
+  // changing anything.  Otherwise, we might get confused if the nodes are
+  // siblings or one is the parent of another.
+  const bool IsLHSRoot = LHS->isRoot(), IsRHSRoot = RHS->isRoot();
+  auto *LHSLocation = IsLHSRoot ? nullptr : &getParentLocation(LHS);
+  auto *RHSLocation = IsRHSRoot ? nullptr : &getParentLocation(RHS);
+
+  if (IsLHSRoot) {
+    LHS->Parent->Parent = RHS;
+  } else {
+    *LHSLocation = RHS;
   }
-  if (not RHS->isRoot()) {
-    getParentLocation(RHS) = LHS;
+  if (IsRHSRoot) {
+    RHS->Parent->Parent = LHS;
+  } else {
+    *RHSLocation = LHS;
   }
+
+  std::swap(LHS->Right, RHS->Right);
+  std::swap(LHS->Left, RHS->Left);
   std::swap(LHS->Parent, RHS->Parent);
+
+  // If one of the nodes was the parent of another, it is pointing to itself
+  // at this point.  Fixing children's pointers to parents fixes that as well.
+  for (auto *Swapped : {LHS, RHS}) {
+    if (Swapped->Left)
+      Swapped->Left->Parent = Swapped;
+    if (Swapped->Right)
+      Swapped->Right->Parent = Swapped;
+  }
 }
 
+/// @brief Put the child of the node in its place.
+///
+/// @tparam NodeType  Type of the node.
+///
+/// @param Old  The node to detach from the tree.
+/// @param New  The only child of @p Old or null.
+///
+/// @pre  @p Old is not a header.
+/// @pre  @p Old has no other children, but @p New.
+///
+/// @post  @p Old is not reachable from the tree anymore.
 template <class NodeType>
 constexpr inline void replace(NodeType *Old, NodeType *New) {
   assert(("Header nodes should not be replaced" && not Old->isHeader()));
+  assert(("The node should have no other children" &&
+          (Old->Left == New or Old->Left == nullptr) &&
+          (Old->Right == New or Old->Right == nullptr)));
 
   if (New != nullptr) {
-    New->Right = Old->Right;
-    New->Left = Old->Left;
     New->Parent = Old->Parent;
   }
-  if (not Old->isRoot()) {
+  if (Old->isRoot()) {
+    // The header's parent is the root of the tree
+    Old->Parent->Parent = New;
+  } else {
     getParentLocation(Old) = New;
   }
 }
 
+/// @brief Call @p Destroy for every node of the sub-tree.
+///
+/// The sub-tree is flattened into a list going through right children while
+/// destroying nodes, which needs neither recursion nor an explicit stack.
+/// Parent pointers are neither used nor maintained.
+///
+/// @param Root  The root of the sub-tree to destroy (can be null).
+/// @param Destroy  Callback destroying one node, it gets the node only when
+///                 the node is not needed by the traversal anymore.
+template <class NodeType, class DestroyFunction>
+constexpr inline void destroyTree(NodeType *Root, DestroyFunction Destroy) {
+  for (auto *Current = Root; Current != nullptr;) {
+    if (auto *Left = Current->Left) {
+      Current->Left = Left->Right;
+      Left->Right = Current;
+      Current = Left;
+    } else {
+      auto *Right = Current->Right;
+      Destroy(Current);
+      Current = Right;
+    }
+  }
+}
+
+/// @brief Build a balanced tree out of the sorted sequence.
+///
+/// Nodes are created in the order of the sequence, which is also the
+/// in-order of the resulting tree.
+///
+/// @tparam NodeType  Type of the node.
+///
+/// @param Current  The iterator to the first element, it is advanced past
+///                 the last consumed element.
+/// @param Count  The number of elements to consume.
+/// @param Create  Callback creating a node out of the element.
+/// @param Destroy  Callback destroying one node.  It is used for the nodes
+///                 created so far if @p Create throws.
+///
+/// @return  The root of the built tree (or null if @p Count is zero).
+///          Setting the parent of the root is the caller's responsibility.
+template <class NodeType, class IteratorType, class CreateFunction,
+          class DestroyFunction>
+inline NodeType *buildTree(IteratorType &Current, std::size_t Count,
+                           CreateFunction &Create, DestroyFunction &Destroy) {
+  if (Count == 0) {
+    return nullptr;
+  }
+
+  // The recursion depth is logarithmic because the tree is balanced
+  const std::size_t LeftCount = (Count - 1) / 2;
+  NodeType *Left = buildTree<NodeType>(Current, LeftCount, Create, Destroy);
+  NodeType *Root = nullptr;
+  try {
+    Root = Create(*Current);
+  } catch (...) {
+    destroyTree(Left, Destroy);
+    throw;
+  }
+  ++Current;
+
+  Root->Left = Left;
+  setParent(Left, Root);
+  try {
+    Root->Right = buildTree<NodeType>(Current, Count - LeftCount - 1, Create,
+                                      Destroy);
+  } catch (...) {
+    destroyTree(Root, Destroy);
+    throw;
+  }
+  setParent(Root->Right, Root);
+  updateAugmentation(Root);
+  return Root;
+}
+
 } // end namespace hammock::utils
@@ -2,8 +2,11 @@
 
 #include "hammock/utils/direction.hpp"
 #include "hammock/utils/node.hpp"
+#include "hammock/utils/prefetch.hpp"
+#include "hammock/utils/type_traits.hpp"
 
 #include <cassert>
+#include <cstddef>
 #include <stack>
 #include <utility>
 
@@ -133,6 +136,23 @@ constexpr inline bool isChild(NodeType *Node) {
   return getChild<TestedDirection>(Node->Parent) == Node;
 }
 
+/// @brief Set the parent of the given node.
+///
+/// @tparam NodeType  Type of the node.
+/// @tparam ParentType  Type of the parent node.
+///
+/// @param Child  The node to set the parent for, can be null.
+/// @param Parent  The new parent of @p Child.
+///
+/// @note  It is a no-op for null nodes and for nodes without parent pointers.
+template <class NodeType, class ParentType>
+constexpr inline void setParent(NodeType *Child, ParentType *Parent) {
+  if constexpr (HasParent<NodeType>) {
+    if (Child != nullptr)
+      Child->Parent = Parent;
+  }
+}
+
 /// @brief Return the reference to the parent's pointer to the given node.
 ///
 /// @tparam NodeType  Type of the node.
@@ -358,6 +378,67 @@ constexpr inline NodeType *successor(NodeType *Node) {
   }
 }
 
+/// @brief Visit the nodes in order, starting from the given one.
+///
+/// Left spines of right sub-trees are walked down once and kept in a small
+/// ring in the frame, the next node is on its top.  When the ring is empty,
+/// the next node is the first ancestor we come to from the left.  Spines
+/// that don't fit lose their upper parts, which are then found by climbing.
+/// Unlike with iterators, nothing is checked for being the header on the
+/// way down.
+///
+/// @tparam NodeType  Type of the node with a pointer to its parent.
+///
+/// @param First  The first node to visit.
+/// @param Last  The node to stop at (not visited), it can be the header.
+/// @param Visitor  Called for every visited node, returns false to stop
+///                 after it.
+///
+/// @return  The node following the last visited one, or null if there
+///          are no more nodes in the tree.
+///
+/// @pre  @p First should not be null or the header.
+template <class NodeType, class LastType, class VisitorType>
+inline NodeType *visitInOrder(NodeType *First, const LastType *Last,
+                              VisitorType Visitor) {
+  constexpr std::size_t Capacity = 64;
+  NodeType *Pending[Capacity];
+  std::size_t Top = 0, Bottom = 0;
+
+  auto *Current = First;
+  while (Current != Last) {
+    for (auto *Child = Current->Right; Child != nullptr; Child = Child->Left) {
+      Pending[Top++ % Capacity] = Child;
+    }
+    // The oldest nodes are overwritten
+    if (Top - Bottom > Capacity) {
+      Bottom = Top - Capacity;
+    }
+
+    NodeType *Next = nullptr;
+    if (Top != Bottom) {
+      Next = Pending[--Top % Capacity];
+      // Its right child is the next one to chase, and it is loaded while
+      // the visitor is busy.
+      prefetch(Next->Right);
+    } else {
+      for (auto *SubTree = Current; not SubTree->isRoot();) {
+        auto *Parent = SubTree->Parent->getRealNode();
+        if (Parent->Left == SubTree) {
+          Next = Parent;
+          break;
+        }
+        SubTree = Parent;
+      }
+    }
+    if (not Visitor(Current) or Next == nullptr) {
+      return Next;
+    }
+    Current = Next;
+  }
+  return Current;
+}
+
 /// @brief Find the node by its key in the valid binary search tree.
 ///
 /// @tparam NodeType  Type of the node.
@@ -378,6 +459,8 @@ constexpr inline NodeType *successor(NodeType *Node) {
 /// @pre  The tree rooted in the given @p Node should be a valid BST w.r.t the
 ///       given @p Comparator.
 /// @pre  The given @p Node is not null.
+///
+/// @note  Pending updates of visited nodes are pushed down to their children.
 template <class NodeType, class Compare>
 constexpr inline std::pair<NodeType *, NodeType *&>
 find(NodeType *Node, const typename NodeType::KeyType &Key,
@@ -403,6 +486,7 @@ find(NodeType *Node, const typename NodeType::KeyType &Key,
   // Iterate till we get to the point where there is no node
   while (*Result != nullptr) {
     Parent = *Result;
+    pushAugmentation(Parent);
 
     if (Comparator(Parent->Key(), Key)) {
       // If the current node's key P ≺ K, we need to go to the right subtree
@@ -423,6 +507,42 @@ find(NodeType *Node, const typename NodeType::KeyType &Key,
   return {Parent, *Result};
 }
 
+/// @brief Find the leftmost node in the tree that doesn't go before
+/// the searched position.
+///
+/// @tparam NodeType  Type of the node.
+/// @tparam PredicateType  Type of the @p IsBefore predicate.
+///
+/// @param Node  The root of the tree to search in.
+/// @param IsBefore  Predicate telling that the given node goes before the
+///                  searched position, i.e. that the search should go right.
+///
+/// @return  A pair of the last visited node and the found node.  The found
+///          node is null if all of the nodes go before the searched position.
+///
+/// @pre  @p IsBefore partitions the tree, i.e. it is true for all of the
+///       nodes up to some point in the in-order and false afterwards.
+///
+/// @note  Pending updates of visited nodes are pushed down to their children
+///        unless the nodes are const.
+template <class NodeType, class PredicateType>
+constexpr inline std::pair<NodeType *, NodeType *>
+partitionPoint(NodeType *Node, PredicateType IsBefore) {
+  NodeType *Last = nullptr, *Found = nullptr;
+  while (Node != nullptr) {
+    Last = Node;
+    pushAugmentation(Node);
+    if (IsBefore(Node)) {
+      Node = Node->Right;
+    } else {
+      // Every node to the left is a better candidate
+      Found = Node;
+      Node = Node->Left;
+    }
+  }
+  return {Last, Found};
+}
+
 /// @brief Check if we should go in the given direction for copying.
 ///
 /// @param Origin  A node from the original tree.
@@ -488,6 +608,10 @@ constexpr inline void copyAndGo(const NodeType *&Origin, NodeType *&Copy,
 ///
 /// @note  This function does NOT copy left/right pointers of the header node
 ///        so it is the caller's responsibility to fix them after the copying.
+///
+/// @note  Nodes are created in pre-order, every node right before its left
+///        sub-tree.  If @p Create places them next to each other, searches
+///        in the copy walk through memory mostly forward.
 template <class NodeType, class CallbackType>
 constexpr inline NodeBase<NodeType>
 copyTree(const NodeBase<NodeType> &OriginalHeader, CallbackType Create) {
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <type_traits>
+#include <utility>
 
 namespace hammock::utils {
 template <class Type, bool Add = true> struct AddConstType;
@@ -13,4 +16,75 @@ template <class Type> struct AddConstType<Type, false> { using Value = Type; };
 
 template <class Type, bool Add = true>
 using AddConst = typename AddConstType<Type, Add>::Value;
+
+/// Iterator category of the given type, it is ill-formed for non-iterators.
+template <class IteratorType>
+using IteratorCategory =
+    typename std::iterator_traits<IteratorType>::iterator_category;
+
+template <class NodeType, class = void>
+struct HasParentType : std::false_type {};
+
+template <class NodeType>
+struct HasParentType<NodeType, std::void_t<decltype(NodeType::Parent)>>
+    : std::true_type {};
+
+/// True if the node of the given type has a pointer to its parent.
+template <class NodeType>
+constexpr inline bool HasParent = HasParentType<NodeType>::value;
+
+template <class NodeType, class = void>
+struct HasAugmentationType : std::false_type {};
+
+template <class NodeType>
+struct HasAugmentationType<NodeType,
+                           std::void_t<typename NodeType::Augmentation::Data>>
+    : std::bool_constant<
+          not std::is_empty_v<typename NodeType::Augmentation::Data>> {};
+
+/// True if the node of the given type keeps some data about its sub-tree.
+template <class NodeType>
+constexpr inline bool HasAugmentation = HasAugmentationType<NodeType>::value;
+
+template <class NodeType, class = void>
+struct HasLazyUpdatesType : std::false_type {};
+
+template <class NodeType>
+struct HasLazyUpdatesType<
+    NodeType, std::void_t<typename NodeType::Augmentation::UpdateType>>
+    : std::true_type {};
+
+/// True if the node of the given type keeps pending updates for its children.
+template <class NodeType>
+constexpr inline bool HasLazyUpdates = HasLazyUpdatesType<NodeType>::value;
+
+template <class AllocatorType, class = void>
+struct CanReleaseAtOnceType : std::false_type {};
+
+template <class AllocatorType>
+struct CanReleaseAtOnceType<
+    AllocatorType,
+    std::void_t<decltype(std::declval<AllocatorType &>().release()),
+                decltype(std::declval<const AllocatorType &>().allocated())>>
+    : std::true_type {};
+
+/// True if the allocator can free everything it allocated at once and
+/// can tell how many objects are still allocated.
+template <class AllocatorType>
+constexpr inline bool CanReleaseAtOnce =
+    CanReleaseAtOnceType<AllocatorType>::value;
+
+template <class AllocatorType, class = void>
+struct CanReserveType : std::false_type {};
+
+template <class AllocatorType>
+struct CanReserveType<AllocatorType,
+                      std::void_t<decltype(std::declval<AllocatorType &>()
+                                               .reserve(std::size_t{}))>>
+    : std::true_type {};
+
+/// True if the allocator can prepare contiguous memory for the given number
+/// of upcoming allocations.
+template <class AllocatorType>
+constexpr inline bool CanReserve = CanReserveType<AllocatorType>::value;
 } // end namespace hammock::utils
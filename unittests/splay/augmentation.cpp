@@ -0,0 +1,657 @@
+#include "hammock/impl/splay.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace hammock;
+
+template <class Policy>
+using OrderedTree =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, Policy,
+                    policy::OrderStatistics>;
+
+template <class Tree> class OrderStatisticsTest : public ::testing::Test {};
+
+using Policies = ::testing::Types<
+    OrderedTree<policy::BottomUp>, OrderedTree<policy::TopDown>,
+    OrderedTree<policy::Probabilistic>, OrderedTree<policy::SemiSplay>,
+    OrderedTree<policy::DepthThreshold>, OrderedTree<policy::Counter>>;
+TYPED_TEST_SUITE(OrderStatisticsTest, Policies);
+
+/// Check every position of the tree, which fails if any of the sub-tree
+/// sizes is stale.
+template <class Tree>
+void checkPositions(const std::map<int, int> &Standard, const Tree &Actual) {
+  ASSERT_EQ(Standard.size(), Actual.size());
+  std::size_t Index = 0;
+  for (const auto &Pair : Standard) {
+    auto Selected = Actual.select(Index);
+    ASSERT_NE(Actual.end(), Selected);
+    EXPECT_EQ(Pair, *Selected);
+    EXPECT_EQ(Index, Actual.index_of(Selected));
+    EXPECT_EQ(Index, Actual.rank(Pair.first));
+    ++Index;
+  }
+  EXPECT_EQ(Actual.end(), Actual.select(Index));
+  EXPECT_EQ(Actual.size(), Actual.index_of(Actual.end()));
+}
+
+TYPED_TEST(OrderStatisticsTest, ModificationsTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 1000; ++i) {
+    int Key = Random() % 500;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+    if (i % 3 == 0) {
+      Key = Random() % 500;
+      Tree.erase(Tree.find(Key));
+      Standard.erase(Key);
+    }
+    if (i % 100 == 0) {
+      checkPositions(Standard, Tree);
+    }
+  }
+  checkPositions(Standard, Tree);
+
+  TypeParam Copy = Tree;
+  checkPositions(Standard, Copy);
+
+  std::vector<std::pair<int, int>> Batch;
+  for (int i = 0; i < 300; ++i) {
+    Batch.emplace_back(Random() % 1000, i);
+  }
+  Tree.insert(Batch.begin(), Batch.end());
+  Standard.insert(Batch.begin(), Batch.end());
+  checkPositions(Standard, Tree);
+
+  TypeParam Built(Batch.begin(), Batch.end());
+  checkPositions(std::map<int, int>(Batch.begin(), Batch.end()), Built);
+}
+
+TYPED_TEST(OrderStatisticsTest, SelectAndRankTest) {
+  TypeParam Tree;
+  for (int i = 0; i < 100; ++i) {
+    Tree.insert({i * 2, i});
+  }
+
+  // Selection splays, it shouldn't break the following queries
+  for (std::size_t i : {50, 0, 99, 13, 77}) {
+    auto It = Tree.select(i);
+    ASSERT_NE(Tree.end(), It);
+    EXPECT_EQ(int(i) * 2, It->first);
+  }
+  EXPECT_EQ(Tree.end(), Tree.select(100));
+
+  EXPECT_EQ(0, Tree.rank(-5));
+  EXPECT_EQ(0, Tree.rank(0));
+  EXPECT_EQ(1, Tree.rank(1));
+  EXPECT_EQ(50, Tree.rank(100));
+  EXPECT_EQ(50, Tree.rank(99));
+  EXPECT_EQ(100, Tree.rank(1000));
+
+  auto First = Tree.find(20), Last = Tree.find(120);
+  EXPECT_EQ(50, Tree.distance(First, Last));
+  EXPECT_EQ(-50, Tree.distance(Last, First));
+  EXPECT_EQ(91, Tree.distance(Tree.find(18), Tree.end()));
+
+  EXPECT_EQ(60, Tree.next(Tree.find(20), 20)->first);
+  EXPECT_EQ(0, Tree.next(Tree.find(20), -10)->first);
+  EXPECT_EQ(Tree.end(), Tree.next(Tree.find(20), -11));
+  EXPECT_EQ(Tree.end(), Tree.next(Tree.find(20), 90));
+
+  std::map<int, int> Standard(Tree.begin(), Tree.end());
+  checkPositions(Standard, Tree);
+}
+
+TYPED_TEST(OrderStatisticsTest, SplitAndJoinTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  for (int i = 0; i < 500; ++i) {
+    Tree.insert({i, i});
+    Standard.insert({i, i});
+  }
+
+  auto Upper = Tree.split(200);
+  std::map<int, int> StandardUpper(Standard.lower_bound(200), Standard.end());
+  Standard.erase(Standard.lower_bound(200), Standard.end());
+  EXPECT_EQ(200, Tree.size());
+  EXPECT_EQ(300, Upper.size());
+  checkPositions(Standard, Tree);
+  checkPositions(StandardUpper, Upper);
+
+  Tree.join(std::move(Upper));
+  Standard.insert(StandardUpper.begin(), StandardUpper.end());
+  checkPositions(Standard, Tree);
+}
+
+/// Polynomial hash of the sequence of values, which depends on their order.
+struct SequenceHash {
+  using value_type = std::pair<std::uint64_t, std::uint64_t>;
+
+  static value_type identity() { return {0, 1}; }
+  static value_type combine(const value_type &LHS, const value_type &RHS) {
+    return {LHS.first * RHS.second + RHS.first, LHS.second * RHS.second};
+  }
+  static value_type lift(int, int Value) {
+    return {static_cast<std::uint64_t>(Value), 1000003};
+  }
+};
+
+template <class Policy>
+using AggregateTree =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, Policy,
+                    policy::Aggregate<SequenceHash>>;
+
+template <class Tree> class AggregateTest : public ::testing::Test {};
+
+using AggregatePolicies = ::testing::Types<
+    AggregateTree<policy::BottomUp>, AggregateTree<policy::TopDown>,
+    AggregateTree<policy::Probabilistic>, AggregateTree<policy::SemiSplay>,
+    AggregateTree<policy::DepthThreshold>, AggregateTree<policy::Counter>>;
+TYPED_TEST_SUITE(AggregateTest, AggregatePolicies);
+
+SequenceHash::value_type expectedHash(const std::map<int, int> &Standard,
+                                      int Lower, int Upper) {
+  auto Result = SequenceHash::identity();
+  for (auto It = Standard.lower_bound(Lower);
+       It != Standard.end() and It->first < Upper; ++It) {
+    Result = SequenceHash::combine(Result,
+                                   SequenceHash::lift(It->first, It->second));
+  }
+  return Result;
+}
+
+TYPED_TEST(AggregateTest, RangeTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  EXPECT_EQ(SequenceHash::identity(), Tree.aggregate(0, 100));
+  for (int i = 0; i < 2000; ++i) {
+    int Key = Random() % 1000;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+    if (i % 4 == 0) {
+      Key = Random() % 1000;
+      Tree.erase(Tree.find(Key));
+      Standard.erase(Key);
+    }
+
+    int Lower = Random() % 1100 - 50, Upper = Lower + Random() % 300;
+    EXPECT_EQ(expectedHash(Standard, Lower, Upper),
+              Tree.aggregate(Lower, Upper));
+    const auto &ConstTree = Tree;
+    EXPECT_EQ(expectedHash(Standard, Upper, Lower + 500),
+              ConstTree.aggregate(Upper, Lower + 500));
+  }
+  EXPECT_EQ(expectedHash(Standard, -1, 1000), Tree.aggregate());
+  EXPECT_EQ(SequenceHash::identity(), Tree.aggregate(500, 500));
+  EXPECT_EQ(SequenceHash::identity(), Tree.aggregate(600, 500));
+
+  // Changing values keeps aggregates up to date
+  for (int Key = 0; Key < 1000; Key += 7) {
+    if (auto It = Tree.find(Key); It != Tree.end()) {
+      Tree.modify(It, [](int &Value) { Value *= 3; });
+      Standard[Key] *= 3;
+    }
+  }
+  EXPECT_EQ(expectedHash(Standard, -1, 1000), Tree.aggregate());
+  EXPECT_EQ(expectedHash(Standard, 100, 700), Tree.aggregate(100, 700));
+
+  TypeParam Copy = Tree;
+  EXPECT_EQ(expectedHash(Standard, 300, 900), Copy.aggregate(300, 900));
+
+  auto Upper = Tree.split(400);
+  EXPECT_EQ(expectedHash(Standard, -1, 400), Tree.aggregate());
+  EXPECT_EQ(expectedHash(Standard, 400, 1000), Upper.aggregate());
+  Tree.join(std::move(Upper));
+  EXPECT_EQ(expectedHash(Standard, 350, 450), Tree.aggregate(350, 450));
+}
+
+TEST(AggregateTest, BuiltinMonoidsTest) {
+  std::vector<std::pair<int, int>> Pairs;
+  for (int i = 0; i < 100; ++i) {
+    Pairs.emplace_back(i, (i * 37) % 101);
+  }
+
+  impl::SplayTree<int, int, std::less<int>,
+                  std::allocator<std::pair<int, int>>, policy::BottomUp,
+                  policy::Aggregate<policy::Sum<long>>>
+      Sums(Pairs.begin(), Pairs.end());
+  impl::SplayTree<int, int, std::less<int>,
+                  std::allocator<std::pair<int, int>>, policy::TopDown,
+                  policy::Aggregate<policy::Min<int>>>
+      Mins(Pairs.begin(), Pairs.end());
+  impl::SplayTree<int, int, std::less<int>,
+                  std::allocator<std::pair<int, int>>, policy::SemiSplay,
+                  policy::Aggregate<policy::Max<int>>>
+      Maxs(Pairs.begin(), Pairs.end());
+
+  for (int Lower = 0; Lower < 100; Lower += 9) {
+    for (int Upper = Lower + 1; Upper <= 100; Upper += 13) {
+      long Sum = 0;
+      int Min = 1000, Max = -1;
+      for (int i = Lower; i < Upper; ++i) {
+        Sum += Pairs[i].second;
+        Min = std::min(Min, Pairs[i].second);
+        Max = std::max(Max, Pairs[i].second);
+      }
+      EXPECT_EQ(Sum, Sums.aggregate(Lower, Upper));
+      EXPECT_EQ(Min, Mins.aggregate(Lower, Upper));
+      EXPECT_EQ(Max, Maxs.aggregate(Lower, Upper));
+    }
+  }
+}
+
+/// Concatenation of the values, long enough to live on the heap.
+struct Concatenation {
+  using value_type = std::string;
+
+  static value_type identity() { return {}; }
+  static value_type combine(const value_type &LHS, const value_type &RHS) {
+    return LHS + RHS;
+  }
+  static value_type lift(int, int Value) {
+    return "[" + std::string(20, 'a' + Value % 26) + "]";
+  }
+};
+
+TEST(AggregateTest, NonTrivialMonoidTest) {
+  impl::SplayTree<int, int, std::less<int>,
+                  std::allocator<std::pair<int, int>>, policy::BottomUp,
+                  policy::Aggregate<Concatenation>>
+      Tree;
+  std::map<int, int> Standard;
+  for (int i = 0; i < 50; ++i) {
+    Tree.insert({i * 7 % 50, i});
+    Standard.insert({i * 7 % 50, i});
+  }
+  Tree.erase(Tree.find(10));
+  Tree.erase(20);
+  Standard.erase(10);
+  Standard.erase(20);
+
+  std::string Expected;
+  for (auto [Key, Value] : Standard) {
+    if (Key >= 5 and Key < 30)
+      Expected += Concatenation::lift(Key, Value);
+  }
+  // Nodes own their aggregates, which are released with the nodes
+  EXPECT_EQ(Expected, Tree.aggregate(5, 30));
+  auto Upper = Tree.split(25);
+  EXPECT_EQ(25 - 2, Tree.size());
+}
+
+using RangeAddAndSum =
+    policy::Lazy<policy::Add<long>,
+                 policy::Aggregate<policy::Sum<long>, policy::OrderStatistics>>;
+
+template <class Policy>
+using LazyTree =
+    impl::SplayTree<int, long, std::less<int>,
+                    std::allocator<std::pair<int, long>>, Policy,
+                    RangeAddAndSum>;
+
+template <class Tree> class LazyUpdateTest : public ::testing::Test {};
+
+using LazyPolicies = ::testing::Types<
+    LazyTree<policy::BottomUp>, LazyTree<policy::TopDown>,
+    LazyTree<policy::Probabilistic>, LazyTree<policy::SemiSplay>,
+    LazyTree<policy::DepthThreshold>, LazyTree<policy::Counter>>;
+TYPED_TEST_SUITE(LazyUpdateTest, LazyPolicies);
+
+long expectedSum(const std::map<int, long> &Standard, int Lower, int Upper) {
+  long Result = 0;
+  for (auto It = Standard.lower_bound(Lower);
+       It != Standard.end() and It->first < Upper; ++It) {
+    Result += It->second;
+  }
+  return Result;
+}
+
+TYPED_TEST(LazyUpdateTest, RangeAddTest) {
+  TypeParam Tree;
+  std::map<int, long> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 3000; ++i) {
+    int Key = Random() % 1000;
+    switch (Random() % 6) {
+    case 0:
+      if (i % 2 == 0) {
+        Tree.insert({Key, i});
+      } else {
+        // Const lookups don't push pending updates on their way down
+        Tree.insert(std::as_const(Tree).lower_bound(Key), {Key, i});
+      }
+      Standard.insert({Key, i});
+      break;
+    case 1:
+      Tree.erase(Tree.find(Key));
+      Standard.erase(Key);
+      break;
+    case 2: {
+      // Values found by non-const lookups are always up to date
+      auto Found = Tree.find(Key);
+      auto Expected = Standard.find(Key);
+      ASSERT_EQ(Expected == Standard.end(), Found == Tree.end());
+      if (Found != Tree.end()) {
+        EXPECT_EQ(Expected->second, Found->second);
+      }
+      break;
+    }
+    case 3: {
+      auto Found = Tree.lower_bound(Key);
+      auto Expected = Standard.lower_bound(Key);
+      ASSERT_EQ(Expected == Standard.end(), Found == Tree.end());
+      if (Found != Tree.end()) {
+        EXPECT_EQ(*Expected, *Found);
+      }
+      break;
+    }
+    default: {
+      int Upper = Key + Random() % 200;
+      long Delta = static_cast<long>(Random() % 21) - 10;
+      Tree.update_range(Key, Upper, Delta);
+      for (auto It = Standard.lower_bound(Key);
+           It != Standard.end() and It->first < Upper; ++It) {
+        It->second += Delta;
+      }
+      break;
+    }
+    }
+
+    int Lower = Random() % 1000;
+    EXPECT_EQ(expectedSum(Standard, Lower, Lower + 100),
+              Tree.aggregate(Lower, Lower + 100));
+  }
+
+  if (not Standard.empty()) {
+    auto Selected = Tree.select(Standard.size() / 2);
+    EXPECT_EQ(*std::next(Standard.begin(), Standard.size() / 2), *Selected);
+  }
+
+  auto Copy = Tree;
+  auto Upper = Tree.split(500);
+  Upper.update_range(0, 2000, 1);
+  Tree.update_range(0, 2000, -1);
+  for (auto &[Key, Value] : Standard) {
+    Value += Key < 500 ? -1 : 1;
+  }
+  Tree.join(std::move(Upper));
+  EXPECT_EQ(expectedSum(Standard, -1, 1000), Tree.aggregate());
+
+  // Mutable iterators push pending updates on their way
+  EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Tree.begin(),
+                         Tree.end()));
+  EXPECT_TRUE(std::equal(Standard.rbegin(), Standard.rend(), Tree.rbegin(),
+                         Tree.rend()));
+  const auto &ConstTree = Tree;
+  for (auto &[Key, Value] : Standard) {
+    EXPECT_EQ(Value, ConstTree.at(Key));
+  }
+
+  Copy.freeze();
+  Copy.update_range(0, 2000, 5);
+  for (auto &[Key, Value] : Standard) {
+    EXPECT_EQ(Value + (Key < 500 ? 6 : 4), Copy.at(Key));
+  }
+}
+
+TYPED_TEST(LazyUpdateTest, ConstAccessTest) {
+  TypeParam Tree;
+  std::map<int, long> Standard;
+  std::mt19937 Random{42};
+  for (int i = 0; i < 1000; ++i) {
+    const int Key = Random() % 5000;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+  }
+  for (int i = 0; i < 20; ++i) {
+    const int Lower = Random() % 5000, Upper = Lower + Random() % 2000;
+    Tree.update_range(Lower, Upper, 1);
+    for (auto It = Standard.lower_bound(Lower);
+         It != Standard.end() and It->first < Upper; ++It) {
+      ++It->second;
+    }
+  }
+
+  // Aggregates see the pending updates without pushing them
+  const auto &ConstTree = Tree;
+  for (int i = 0; i < 200; ++i) {
+    const int Lower = Random() % 5000, Upper = Lower + Random() % 1000;
+    EXPECT_EQ(expectedSum(Standard, Lower, Upper),
+              ConstTree.aggregate(Lower, Upper));
+  }
+  EXPECT_EQ(expectedSum(Standard, 0, 5000), ConstTree.aggregate());
+
+  // Lookups push them on their way
+  for (int Key = 0; Key < 5000; Key += 3) {
+    auto Found = ConstTree.find(Key);
+    auto Expected = Standard.find(Key);
+    ASSERT_EQ(Expected == Standard.end(), Found == ConstTree.end());
+    if (Found != ConstTree.end()) {
+      EXPECT_EQ(Expected->second, Found->second);
+    }
+    auto Lower = ConstTree.lower_bound(Key);
+    if (Lower != ConstTree.end()) {
+      EXPECT_EQ(*Standard.lower_bound(Key), *Lower);
+    }
+  }
+  for (auto &[Key, Value] : Standard) {
+    EXPECT_EQ(Value, ConstTree.at(Key));
+  }
+}
+
+TYPED_TEST(LazyUpdateTest, BoundsTest) {
+  {
+    TypeParam Tree;
+    for (int Key : {4, 2, 17, 3, 1, 11}) {
+      Tree.insert({Key, 0});
+    }
+    Tree.update_range(1, 18, 1);
+    EXPECT_EQ((std::pair<const int, long>{3, 1}), *Tree.upper_bound(2));
+  }
+
+  TypeParam Tree;
+  std::map<int, long> Standard;
+  std::mt19937 Random{42};
+  for (int i = 0; i < 200; ++i) {
+    const int Key = Random() % 300;
+    Tree.insert({Key, 0});
+    Standard.insert({Key, 0});
+  }
+
+  for (int i = 0; i < 2000; ++i) {
+    const int Key = Random() % 300, Upper = Key + Random() % 100;
+    Tree.update_range(Key, Upper, 1);
+    for (auto It = Standard.lower_bound(Key);
+         It != Standard.end() and It->first < Upper; ++It) {
+      ++It->second;
+    }
+
+    // Neighbors of the splayed node should have their updates too
+    const int Probe = Random() % 300;
+    auto Found = Tree.upper_bound(Probe);
+    auto Expected = Standard.upper_bound(Probe);
+    ASSERT_EQ(Expected == Standard.end(), Found == Tree.end());
+    if (Found != Tree.end()) {
+      EXPECT_EQ(*Expected, *Found);
+    }
+    auto [Lower, Next] = Tree.equal_range(Probe);
+    auto [ExpectedLower, ExpectedNext] = Standard.equal_range(Probe);
+    ASSERT_EQ(ExpectedNext == Standard.end(), Next == Tree.end());
+    if (Next != Tree.end()) {
+      EXPECT_EQ(*ExpectedNext, *Next);
+    }
+    Found = Tree.lower_bound(Probe);
+    Expected = Standard.lower_bound(Probe);
+    ASSERT_EQ(Expected == Standard.end(), Found == Tree.end());
+    if (Found != Tree.end()) {
+      EXPECT_EQ(*Expected, *Found);
+    }
+  }
+}
+
+TYPED_TEST(LazyUpdateTest, IterationTest) {
+  TypeParam Tree;
+  std::map<int, long> Standard;
+  std::mt19937 Random{7};
+  for (int i = 0; i < 300; ++i) {
+    const int Key = Random() % 1000;
+    Tree.insert({Key, 0});
+    Standard.insert({Key, 0});
+  }
+
+  for (int i = 0; i < 300; ++i) {
+    const int Key = Random() % 1000, Upper = Key + Random() % 300;
+    Tree.update_range(Key, Upper, i);
+    for (auto It = Standard.lower_bound(Key);
+         It != Standard.end() and It->first < Upper; ++It) {
+      It->second += i;
+    }
+
+    // Walks from anywhere in both directions
+    const int Start = Random() % 1000;
+    auto TreeIt = Tree.lower_bound(Start);
+    auto StandardIt = Standard.lower_bound(Start);
+    for (int Step = 0; Step < 20 and StandardIt != Standard.end(); ++Step) {
+      ASSERT_EQ(*StandardIt++, *TreeIt++);
+    }
+    auto TreeBack = Tree.end();
+    auto StandardBack = Standard.end();
+    for (int Step = 0; Step < 20 and StandardBack != Standard.begin();
+         ++Step) {
+      ASSERT_EQ(*--StandardBack, *--TreeBack);
+    }
+    EXPECT_EQ(*Standard.begin(), *Tree.begin());
+    EXPECT_EQ(*Standard.rbegin(), *Tree.rbegin());
+  }
+  EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Tree.begin(),
+                         Tree.end()));
+}
+
+TYPED_TEST(LazyUpdateTest, EraseRangeTest) {
+  TypeParam Tree;
+  std::map<int, long> Standard;
+  for (int i = 0; i < 1000; ++i) {
+    Tree.insert({i, i});
+    Standard.emplace(i, i);
+  }
+
+  std::mt19937 Random{42};
+  while (Standard.size() > 100) {
+    const int Key = Random() % 1000;
+    const int Upper = Key + Random() % 30;
+    Tree.update_range(Key / 2, Upper * 2, 1);
+    for (auto It = Standard.lower_bound(Key / 2);
+         It != Standard.end() and It->first < Upper * 2; ++It) {
+      ++It->second;
+    }
+
+    if (Random() % 2) {
+      Tree.erase(Tree.lower_bound(Key), Tree.lower_bound(Upper));
+      Standard.erase(Standard.lower_bound(Key), Standard.lower_bound(Upper));
+    } else {
+      EXPECT_EQ(Standard.erase(Key), Tree.erase(Key));
+    }
+
+    ASSERT_EQ(Standard.size(), Tree.size());
+    const int Lower = Random() % 1000;
+    EXPECT_EQ(expectedSum(Standard, Lower, Lower + 100),
+              Tree.aggregate(Lower, Lower + 100));
+    EXPECT_EQ(expectedSum(Standard, 0, 1000), Tree.aggregate());
+  }
+  EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Tree.begin(),
+                         Tree.end()));
+}
+
+TYPED_TEST(LazyUpdateTest, NodeHandleTest) {
+  TypeParam Tree, Other;
+  std::map<int, long> Standard, OtherStandard;
+  for (int i = 0; i < 500; ++i) {
+    Tree.insert({i, i});
+    Standard.emplace(i, i);
+  }
+
+  std::mt19937 Random{42};
+  for (int i = 0; i < 200; ++i) {
+    const int Key = Random() % 500;
+    const int Upper = Key + Random() % 100;
+    Tree.update_range(Key, Upper, 1);
+    Other.update_range(Key, Upper, -1);
+    for (auto It = Standard.lower_bound(Key);
+         It != Standard.end() and It->first < Upper; ++It) {
+      ++It->second;
+    }
+    for (auto It = OtherStandard.lower_bound(Key);
+         It != OtherStandard.end() and It->first < Upper; ++It) {
+      --It->second;
+    }
+
+    // Extracted values have all of the updates applied before, and none
+    // of the updates of the other tree.
+    if (auto Handle = Tree.extract(Random() % 500)) {
+      EXPECT_EQ(Standard.at(Handle.key()), Handle.mapped());
+      OtherStandard.insert(Standard.extract(Handle.key()));
+      Other.insert(std::move(Handle));
+    }
+    const int Lower = Random() % 500;
+    EXPECT_EQ(expectedSum(Standard, Lower, Lower + 100),
+              Tree.aggregate(Lower, Lower + 100));
+    EXPECT_EQ(expectedSum(OtherStandard, Lower, Lower + 100),
+              Other.aggregate(Lower, Lower + 100));
+  }
+
+  Tree.update_range(0, 500, 1);
+  for (auto &[Key, Value] : Standard) {
+    ++Value;
+  }
+  Other.merge(Tree);
+  OtherStandard.merge(Standard);
+  EXPECT_TRUE(Tree.empty());
+  EXPECT_EQ(expectedSum(OtherStandard, 0, 500), Other.aggregate());
+  EXPECT_TRUE(std::equal(OtherStandard.begin(), OtherStandard.end(),
+                         Other.begin(), Other.end()));
+}
+
+TEST(LazyUpdateTest, ModifyTest) {
+  impl::SplayTree<int, long, std::less<int>,
+                  std::allocator<std::pair<int, long>>, policy::SemiSplay,
+                  policy::Lazy<policy::Add<long>, policy::OrderStatistics>>
+      Tree;
+  for (int i = 0; i < 100; ++i) {
+    Tree.insert({i, 0});
+  }
+  Tree.update_range(10, 90, 5);
+  // The modified value has all of the updates applied before
+  Tree.modify(Tree.find(50), [](long &Value) { Value *= 2; });
+  Tree.update_range(40, 60, 1);
+  EXPECT_EQ(11, Tree.find(50)->second);
+  EXPECT_EQ(6, Tree.find(40)->second);
+  EXPECT_EQ(5, Tree.find(60)->second);
+  EXPECT_EQ(0, Tree.find(9)->second);
+  EXPECT_EQ(0, Tree.find(90)->second);
+
+  // Rotations push pending updates even if nothing was pushed on the way
+  // to the splayed node.
+  for (int Key = 20; Key < 80; Key += 3) {
+    auto Position = Tree.find(Key);
+    Tree.index_of(++Position);
+    Tree.update_range(0, 100, 1);
+  }
+  EXPECT_EQ(31, Tree.find(50)->second);
+  EXPECT_EQ(25, Tree.find(30)->second);
+  EXPECT_EQ(20, Tree.find(0)->second);
+}
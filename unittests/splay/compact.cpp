@@ -0,0 +1,118 @@
+#include "hammock/impl/compact_splay.hpp"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace hammock::impl;
+
+static_assert(sizeof(CompactSplayTree<int, int>::Node) ==
+                  2 * sizeof(void *) + sizeof(std::pair<int, int>),
+              "Compact nodes should have only two pointers");
+
+template <class Tree>
+void checkEqual(const std::map<int, std::string> &Standard,
+                const Tree &Actual) {
+  EXPECT_EQ(Standard.size(), Actual.size());
+  ASSERT_TRUE(std::equal(Standard.begin(), Standard.end(), Actual.begin(),
+                         Actual.end()));
+  ASSERT_TRUE(std::equal(Standard.rbegin(), Standard.rend(), Actual.rbegin(),
+                         Actual.rend()));
+}
+
+TEST(CompactSplayTest, InsertAndFindTest) {
+  CompactSplayTree<int, std::string> Tree;
+  std::map<int, std::string> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 1000; ++i) {
+    int Key = Random() % 500;
+    auto Value = std::to_string(i) + " is a long enough string to allocate";
+    auto [StandardIt, StandardInserted] = Standard.insert({Key, Value});
+    auto [TreeIt, TreeInserted] = Tree.insert({Key, Value});
+
+    EXPECT_EQ(StandardInserted, TreeInserted);
+    EXPECT_EQ(*StandardIt, *TreeIt);
+  }
+  checkEqual(Standard, Tree);
+
+  for (int Key = -10; Key < 510; ++Key) {
+    auto It = Tree.find(Key);
+    if (Standard.count(Key)) {
+      ASSERT_NE(It, Tree.end());
+      EXPECT_EQ(It->second, Standard[Key]);
+      // Iterators from find should be able to go both ways
+      if (auto Next = std::next(Standard.find(Key)); Next != Standard.end()) {
+        EXPECT_EQ(std::next(It)->first, Next->first);
+      }
+      if (auto Current = Standard.find(Key); Current != Standard.begin()) {
+        EXPECT_EQ(std::prev(It)->first, std::prev(Current)->first);
+      }
+    } else {
+      EXPECT_EQ(It, Tree.end());
+    }
+  }
+  checkEqual(Standard, Tree);
+}
+
+TEST(CompactSplayTest, EraseTest) {
+  CompactSplayTree<int, std::string> Tree;
+  std::map<int, std::string> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 1000; ++i) {
+    int Key = Random() % 500;
+    auto Value = std::to_string(i) + " is a long enough string to allocate";
+    Tree.insert({Key, Value});
+    Standard.insert({Key, Value});
+  }
+
+  while (not Standard.empty()) {
+    int Key = std::next(Standard.begin(), Random() % Standard.size())->first;
+    auto StandardIt = Standard.erase(Standard.find(Key));
+    auto TreeIt = Tree.erase(Tree.find(Key));
+
+    if (StandardIt == Standard.end()) {
+      EXPECT_EQ(TreeIt, Tree.end());
+    } else {
+      ASSERT_NE(TreeIt, Tree.end());
+      EXPECT_EQ(TreeIt->first, StandardIt->first);
+    }
+    checkEqual(Standard, Tree);
+  }
+  EXPECT_TRUE(Tree.empty());
+}
+
+TEST(CompactSplayTest, CopyAndMoveTest) {
+  CompactSplayTree<int, std::string> Tree;
+  std::map<int, std::string> Standard;
+  for (int i = 0; i < 100; ++i) {
+    Tree.emplace(i * 7 % 100, std::to_string(i));
+    Standard.emplace(i * 7 % 100, std::to_string(i));
+  }
+
+  CompactSplayTree<int, std::string> Copy{Tree};
+  checkEqual(Standard, Copy);
+
+  CompactSplayTree<int, std::string> Moved{std::move(Tree)};
+  EXPECT_TRUE(Tree.empty());
+  checkEqual(Standard, Moved);
+
+  Tree = Copy;
+  checkEqual(Standard, Tree);
+  Copy.clear();
+  EXPECT_TRUE(Copy.empty());
+  EXPECT_EQ(Copy.begin(), Copy.end());
+  checkEqual(Standard, Tree);
+}
+
+TEST(CompactSplayTest, TryEmplaceAndAtTest) {
+  CompactSplayTree<int, std::string> Tree;
+  EXPECT_THROW(Tree.at(10), std::out_of_range);
+  EXPECT_TRUE(Tree.try_emplace(10, 3, 'a').second);
+  EXPECT_FALSE(Tree.try_emplace(10, 3, 'b').second);
+  EXPECT_EQ(Tree.at(10), "aaa");
+  EXPECT_TRUE(Tree.contains(10));
+  EXPECT_EQ(Tree.count(11), 0);
+}
@@ -0,0 +1,81 @@
+#include "hammock/impl/concurrent_splay.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace hammock::impl;
+
+TEST(ConcurrentSplayTest, SingleThreadTest) {
+  ConcurrentSplayTree<int, int> Tree{1};
+  EXPECT_TRUE(Tree.insert({1, 10}));
+  EXPECT_FALSE(Tree.insert({1, 20}));
+  EXPECT_EQ(10, Tree.find(1));
+  EXPECT_EQ(std::nullopt, Tree.find(2));
+  EXPECT_TRUE(Tree.contains(1));
+
+  int Visited = 0;
+  EXPECT_TRUE(Tree.visit(1, [&Visited](int Value) { Visited = Value; }));
+  EXPECT_FALSE(Tree.visit(2, [&Visited](int Value) { Visited = Value; }));
+  EXPECT_EQ(10, Visited);
+
+  decltype(Tree)::Batch Writes;
+  for (int i = 2; i < 100; ++i) {
+    Writes.insert({i, i * 10});
+  }
+  Writes.erase(1);
+  Writes.erase(1000);
+  EXPECT_EQ(100, Writes.size());
+  Tree.apply(std::move(Writes));
+  EXPECT_EQ(98, Tree.size());
+  EXPECT_FALSE(Tree.contains(1));
+  EXPECT_EQ(500, Tree.find(50));
+
+  EXPECT_TRUE(Tree.erase(50));
+  EXPECT_FALSE(Tree.erase(50));
+  Tree.clear();
+  EXPECT_TRUE(Tree.empty());
+}
+
+TEST(ConcurrentSplayTest, ReadersAndWritersTest) {
+  constexpr int NumberOfKeys = 1000, NumberOfReaders = 4;
+  ConcurrentSplayTree<int, int> Tree{4};
+  for (int i = 0; i < NumberOfKeys; i += 2) {
+    Tree.insert({i, i});
+  }
+
+  std::atomic<bool> Failed = false;
+  std::vector<std::thread> Threads;
+  for (int Reader = 0; Reader < NumberOfReaders; ++Reader) {
+    Threads.emplace_back([&Tree, &Failed, Reader] {
+      for (int i = 0; i < 20000; ++i) {
+        const int Key = (i * 7 + Reader) % NumberOfKeys;
+        auto Value = Tree.find(Key);
+        // Even keys are never erased, odd keys come and go
+        if ((Key % 2 == 0 and Value != Key) or (Value and *Value != Key)) {
+          Failed = true;
+        }
+      }
+    });
+  }
+  Threads.emplace_back([&Tree] {
+    for (int Round = 0; Round < 20; ++Round) {
+      decltype(Tree)::Batch Writes;
+      for (int i = 1; i < NumberOfKeys; i += 2) {
+        if (Round % 2 == 0) {
+          Writes.insert({i, i});
+        } else {
+          Writes.erase(i);
+        }
+      }
+      Tree.apply(std::move(Writes));
+    }
+  });
+
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ(NumberOfKeys / 2, Tree.size());
+}
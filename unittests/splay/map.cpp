@@ -0,0 +1,263 @@
+#include "hammock/splay.hpp"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using hammock::SplayTree;
+
+template <class Map>
+void checkEqual(const std::map<int, std::string> &Standard,
+                const Map &Actual) {
+  EXPECT_EQ(Standard.size(), Actual.size());
+  ASSERT_TRUE(std::equal(Standard.begin(), Standard.end(), Actual.begin(),
+                         Actual.end()));
+  ASSERT_TRUE(std::equal(Standard.rbegin(), Standard.rend(), Actual.rbegin(),
+                         Actual.rend()));
+}
+
+template <class SplayPolicy> class SplayMapTest : public testing::Test {
+public:
+  using Map = SplayTree<int, std::string, std::less<int>,
+                        std::allocator<std::pair<const int, std::string>>,
+                        SplayPolicy>;
+};
+
+using Policies = testing::Types<hammock::policy::BottomUp,
+                                hammock::policy::TopDown,
+                                hammock::policy::SemiSplay>;
+TYPED_TEST_SUITE(SplayMapTest, Policies, );
+
+TYPED_TEST(SplayMapTest, ModificationsTest) {
+  typename TestFixture::Map Tree;
+  std::map<int, std::string> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 5000; ++i) {
+    const int Key = Random() % 300;
+    const auto Value = std::to_string(i);
+    switch (Random() % 8) {
+    case 0:
+      EXPECT_EQ(Standard.erase(Key), Tree.erase(Key));
+      break;
+    case 1:
+      EXPECT_EQ(Standard.insert_or_assign(Key, Value).second,
+                Tree.insert_or_assign(Key, Value).second);
+      break;
+    case 2:
+      EXPECT_EQ(Standard.try_emplace(Key, Value).second,
+                Tree.try_emplace(Key, Value).second);
+      break;
+    case 3:
+      Standard[Key] += Value;
+      Tree[Key] += Value;
+      break;
+    case 4: {
+      auto It = Tree.emplace_hint(Tree.lower_bound(Key), Key, Value);
+      EXPECT_EQ(*Standard.emplace(Key, Value).first, *It);
+      break;
+    }
+    case 5: {
+      auto From = Tree.lower_bound(Key), To = Tree.upper_bound(Key + 3);
+      auto Next = Tree.erase(From, To);
+      auto StandardNext = Standard.erase(Standard.lower_bound(Key),
+                                         Standard.upper_bound(Key + 3));
+      if (StandardNext == Standard.end()) {
+        EXPECT_EQ(Tree.end(), Next);
+      } else {
+        EXPECT_EQ(*StandardNext, *Next);
+      }
+      break;
+    }
+    case 6:
+      EXPECT_EQ(Standard.count(Key), Tree.count(Key));
+      if (Standard.count(Key)) {
+        EXPECT_EQ(Standard.at(Key), Tree.at(Key));
+      } else {
+        EXPECT_THROW(Tree.at(Key), std::out_of_range);
+      }
+      break;
+    default:
+      EXPECT_EQ(Standard.insert({Key, Value}).second,
+                Tree.insert({Key, Value}).second);
+    }
+  }
+  checkEqual(Standard, Tree);
+
+  std::vector<std::pair<int, std::string>> Batch;
+  for (int i = 0; i < 100; ++i) {
+    Batch.emplace_back(Random() % 600, "batch");
+  }
+  Standard.insert(Batch.begin(), Batch.end());
+  Tree.insert(Batch.begin(), Batch.end());
+  checkEqual(Standard, Tree);
+
+  auto IsOdd = [](const auto &Pair) { return Pair.first % 2 != 0; };
+  std::size_t Erased = 0;
+  for (auto It = Standard.begin(); It != Standard.end();) {
+    if (IsOdd(*It)) {
+      It = Standard.erase(It);
+      ++Erased;
+    } else {
+      ++It;
+    }
+  }
+  EXPECT_EQ(Erased, hammock::erase_if(Tree, IsOdd));
+  checkEqual(Standard, Tree);
+}
+
+TYPED_TEST(SplayMapTest, LookupsTest) {
+  const typename TestFixture::Map Tree{{1, "one"}, {3, "three"}, {5, "five"}};
+
+  EXPECT_EQ(Tree.end(), Tree.find(2));
+  EXPECT_EQ("three", Tree.find(3)->second);
+  EXPECT_TRUE(Tree.contains(5));
+  EXPECT_EQ(3, Tree.lower_bound(2)->first);
+  EXPECT_EQ(5, Tree.upper_bound(3)->first);
+  auto [First, Last] = Tree.equal_range(3);
+  EXPECT_EQ(1, std::distance(First, Last));
+
+  typename TestFixture::Map Copy = Tree;
+  typename TestFixture::Map::const_iterator It = Copy.find(1);
+  EXPECT_EQ(Copy.cbegin(), It);
+  EXPECT_TRUE(Copy.value_comp()(*Copy.begin(), *std::next(Copy.begin())));
+  EXPECT_FALSE(Copy.key_comp()(3, 1));
+}
+
+TYPED_TEST(SplayMapTest, TransparentLookupsTest) {
+  SplayTree<std::string, int, std::less<>,
+            std::allocator<std::pair<const std::string, int>>, TypeParam>
+      Tree{{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+  const auto &ConstTree = Tree;
+  const std::string_view Banana = "banana";
+
+  EXPECT_EQ(2, Tree.find(Banana)->second);
+  EXPECT_EQ(2, ConstTree.find("banana")->second);
+  EXPECT_EQ(Tree.end(), Tree.find("blueberry"));
+  EXPECT_EQ(ConstTree.end(), ConstTree.find(std::string_view{"date"}));
+  EXPECT_TRUE(Tree.contains("cherry"));
+  EXPECT_FALSE(ConstTree.contains(std::string_view{"aaa"}));
+  EXPECT_EQ(1, Tree.count(Banana));
+  EXPECT_EQ(0, ConstTree.count("zucchini"));
+
+  EXPECT_EQ("banana", Tree.lower_bound("b")->first);
+  EXPECT_EQ("cherry", ConstTree.upper_bound(Banana)->first);
+  auto [Lower, Upper] = Tree.equal_range(Banana);
+  EXPECT_EQ(1, std::distance(Lower, Upper));
+  auto [ConstLower, ConstUpper] = ConstTree.equal_range("blueberry");
+  EXPECT_EQ(ConstLower, ConstUpper);
+}
+
+TEST(SplayMapTest, ComparisonsTest) {
+  const SplayTree<int, int> Small{{1, 1}, {2, 2}};
+  SplayTree<int, int> Same{{2, 2}, {1, 1}};
+  const SplayTree<int, int> Large{{1, 1}, {2, 3}};
+  const SplayTree<int, int> Longer{{1, 1}, {2, 2}, {3, 3}};
+
+  EXPECT_EQ(Small, Same);
+  EXPECT_NE(Small, Large);
+  EXPECT_LT(Small, Large);
+  EXPECT_LT(Small, Longer);
+  EXPECT_LE(Small, Same);
+  EXPECT_GT(Large, Longer);
+  EXPECT_GE(Large, Small);
+
+  Same[3] = 3;
+  EXPECT_EQ(Longer, Same);
+  Same.clear();
+  EXPECT_LT(Same, Small);
+
+  swap(Same, Same);
+  using std::swap;
+  SplayTree<int, int> Other = Small;
+  swap(Same, Other);
+  EXPECT_TRUE(Other.empty());
+  EXPECT_EQ(Small, Same);
+}
+
+TEST(SplayMapTest, MergeTest) {
+  SplayTree<int, std::string> Target{{1, "target"}, {3, "target"}};
+  SplayTree<int, std::string, std::greater<int>> Source{
+      {1, "source"}, {2, "source"}, {4, "source"}};
+
+  Target.merge(Source);
+  const std::map<int, std::string> Expected{
+      {1, "target"}, {2, "source"}, {3, "target"}, {4, "source"}};
+  checkEqual(Expected, Target);
+  EXPECT_EQ(1, Source.size());
+  EXPECT_EQ("source", Source.at(1));
+}
+
+TEST(SplayMapTest, NodeHandleTest) {
+  using Map = SplayTree<std::string, std::unique_ptr<int>>;
+  Map First, Second;
+  First.try_emplace("one", std::make_unique<int>(1));
+  First.try_emplace("two", std::make_unique<int>(2));
+  Second.try_emplace("two", std::make_unique<int>(22));
+
+  Map::node_type Handle = First.extract("one");
+  ASSERT_FALSE(Handle.empty());
+  const int *Value = Handle.mapped().get();
+  EXPECT_EQ(1, First.size());
+
+  Map::insert_return_type Result = Second.insert(std::move(Handle));
+  EXPECT_TRUE(Result.inserted);
+  EXPECT_EQ(Value, Second.at("one").get());
+
+  // The node stays with the handle if the key is already there
+  Result = Second.insert(First.extract(First.begin()));
+  EXPECT_FALSE(Result.inserted);
+  EXPECT_EQ("two", Result.node.key());
+  EXPECT_EQ(22, *Result.position->second);
+  EXPECT_TRUE(First.empty());
+
+  Result.node.key() = "three";
+  First.insert(First.end(), std::move(Result.node));
+  First.merge(Second);
+  EXPECT_EQ(3, First.size());
+  EXPECT_EQ(Value, First.at("one").get());
+  EXPECT_EQ(2, *First.at("three"));
+  EXPECT_TRUE(Second.empty());
+}
+
+TEST(SplayMapTest, ForEachTest) {
+  const SplayTree<int, std::string> Tree{
+      {3, "three"}, {1, "one"}, {4, "four"}, {2, "two"}};
+  std::string Joined;
+  Tree.for_each([&Joined](const auto &Pair) { Joined += Pair.second; });
+  EXPECT_EQ("onetwothreefour", Joined);
+
+  const std::pair<const int, std::string> *Buffer[3];
+  auto From = Tree.find(2);
+  EXPECT_EQ(3, Tree.gather(From, Tree.end(), Buffer, 3));
+  EXPECT_EQ("four", Buffer[2]->second);
+  EXPECT_EQ(Tree.end(), From);
+}
+
+TEST(SplayMapTest, MoveOnlyTest) {
+  SplayTree<std::string, std::unique_ptr<int>> Tree;
+  Tree.try_emplace("one", std::make_unique<int>(1));
+  Tree["two"] = std::make_unique<int>(2);
+  std::string Key = "three";
+  Tree.insert_or_assign(std::move(Key), std::make_unique<int>(3));
+  Tree.insert_or_assign("one", std::make_unique<int>(11));
+
+  EXPECT_EQ(3, Tree.size());
+  EXPECT_EQ(11, *Tree.at("one"));
+  EXPECT_EQ(2, *Tree.at("two"));
+  EXPECT_EQ(3, *Tree.at("three"));
+
+  // Top-down insertion places the node after the key is moved into it
+  SplayTree<std::string, int, std::less<std::string>,
+            std::allocator<std::pair<const std::string, int>>,
+            hammock::policy::TopDown>
+      TopDown;
+  for (std::string Key : {"b", "c", "a"})
+    TopDown.insert_or_assign(std::move(Key), 0);
+  EXPECT_EQ("a", TopDown.begin()->first);
+  EXPECT_EQ("c", TopDown.rbegin()->first);
+}
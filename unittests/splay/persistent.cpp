@@ -0,0 +1,180 @@
+#include "hammock/impl/persistent_splay.hpp"
+#include "hammock/utils/pool.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hammock;
+using namespace hammock::impl;
+
+template <class Tree>
+void checkEqual(const std::map<int, std::string> &Standard,
+                const Tree &Actual) {
+  EXPECT_EQ(Standard.size(), Actual.size());
+  ASSERT_TRUE(std::equal(Standard.begin(), Standard.end(), Actual.begin(),
+                         Actual.end()));
+  ASSERT_TRUE(std::equal(Standard.rbegin(), Standard.rend(), Actual.rbegin(),
+                         Actual.rend()));
+}
+
+TEST(PersistentSplayTest, ModificationsTest) {
+  PersistentSplayTree<int, std::string> Tree;
+  std::map<int, std::string> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 3000; ++i) {
+    const int Key = Random() % 500;
+    auto Value = std::to_string(i) + " is a long enough string to allocate";
+    switch (Random() % 4) {
+    case 0:
+      EXPECT_EQ(Standard.erase(Key), Tree.erase(Key));
+      break;
+    case 1:
+      EXPECT_EQ(Standard.insert_or_assign(Key, Value).second,
+                Tree.insert_or_assign(Key, Value).second);
+      break;
+    case 2:
+      if (auto It = Standard.find(Key); It != Standard.end()) {
+        EXPECT_EQ(It->second, Tree.at(Key));
+      } else {
+        EXPECT_EQ(Tree.end(), Tree.find(Key));
+        EXPECT_THROW(Tree.at(Key), std::out_of_range);
+      }
+      break;
+    default:
+      EXPECT_EQ(Standard.insert({Key, Value}).second,
+                Tree.insert({Key, Value}).second);
+    }
+  }
+  checkEqual(Standard, Tree);
+
+  Tree.clear();
+  EXPECT_TRUE(Tree.empty());
+  EXPECT_EQ(Tree.begin(), Tree.end());
+}
+
+TEST(PersistentSplayTest, SnapshotTest) {
+  using Tree = PersistentSplayTree<int, std::string>;
+  Tree Live;
+  std::map<int, std::string> Standard;
+  std::vector<std::pair<Tree::Snapshot, std::map<int, std::string>>> History;
+  std::mt19937 Random{7};
+
+  for (int i = 0; i < 5000; ++i) {
+    if (i % 500 == 0) {
+      History.emplace_back(Live.snapshot(), Standard);
+    }
+    const int Key = Random() % 300;
+    if (Random() % 3 == 0) {
+      Standard.erase(Key);
+      Live.erase(Key);
+    } else {
+      Standard.insert_or_assign(Key, std::to_string(i));
+      Live.insert_or_assign(Key, std::to_string(i));
+    }
+    // Lookups splay the tree as well
+    Live.find(Random() % 300);
+  }
+  checkEqual(Standard, Live);
+
+  for (auto &[Snapshot, Expected] : History) {
+    checkEqual(Expected, Snapshot);
+    for (int Key = -5; Key < 305; ++Key) {
+      if (auto It = Expected.find(Key); It != Expected.end()) {
+        ASSERT_NE(Snapshot.end(), Snapshot.find(Key));
+        EXPECT_EQ(It->second, Snapshot.at(Key));
+        if (auto Next = std::next(It); Next != Expected.end()) {
+          EXPECT_EQ(Next->first, std::next(Snapshot.find(Key))->first);
+        }
+      } else {
+        EXPECT_FALSE(Snapshot.contains(Key));
+      }
+    }
+  }
+
+  // Copies of the tree are independent, but share nodes too
+  Tree Copy = Live;
+  Copy.insert_or_assign(1000, "only in the copy");
+  Copy.erase(Standard.begin()->first);
+  checkEqual(Standard, Live);
+  EXPECT_EQ(Standard.size(), Copy.size());
+  EXPECT_EQ("only in the copy", Copy.at(1000));
+
+  // Snapshots outlive the tree
+  auto Last = History.back();
+  History.clear();
+  Live.clear();
+  checkEqual(Last.second, Last.first);
+}
+
+TEST(PersistentSplayTest, SharingTest) {
+  using Tree =
+      PersistentSplayTree<int, int, std::less<int>,
+                          utils::PoolAllocator<std::pair<const int, int>>>;
+  Tree Live;
+  for (int i = 0; i < 1000; ++i) {
+    Live.insert({(i * 7919) % 1000, i});
+  }
+  auto Allocator = Live.get_allocator();
+  EXPECT_EQ(1000, Allocator.allocated());
+
+  {
+    auto Snapshot = Live.snapshot();
+    EXPECT_EQ(1000, Allocator.allocated());
+
+    // Only the nodes on the search paths are copied
+    for (int Key : {500, 501, 502}) {
+      Live.find(Key);
+    }
+    const auto Copied = Allocator.allocated() - 1000;
+    EXPECT_LT(0, Copied);
+    EXPECT_GT(100, Copied);
+
+    Live.at(500) = -1;
+    EXPECT_NE(-1, Snapshot.at(500));
+  }
+  // Nodes that belonged only to the snapshot are gone with it
+  EXPECT_EQ(1000, Allocator.allocated());
+
+  Live.clear();
+  EXPECT_EQ(0, Allocator.allocated());
+}
+
+TEST(PersistentSplayTest, ReadersAndWriterTest) {
+  constexpr int NumberOfKeys = 1000, NumberOfReaders = 3;
+  PersistentSplayTree<int, int> Live;
+  for (int i = 0; i < NumberOfKeys; ++i) {
+    Live.insert({i, 0});
+  }
+
+  std::atomic<bool> Failed = false;
+  std::vector<std::thread> Readers;
+  for (int Reader = 0; Reader < NumberOfReaders; ++Reader) {
+    // Every snapshot is consistent: all of its values are the same
+    Readers.emplace_back([Snapshot = Live.snapshot(), &Failed] {
+      const int Expected = Snapshot.begin()->second;
+      for (int Round = 0; Round < 20; ++Round) {
+        int Count = 0;
+        for (const auto &[Key, Value] : Snapshot) {
+          Count += Value == Expected;
+        }
+        if (Count != NumberOfKeys) {
+          Failed = true;
+        }
+      }
+    });
+    for (int i = 0; i < NumberOfKeys; ++i) {
+      Live.at(i) = Reader + 1;
+    }
+  }
+
+  for (auto &Reader : Readers) {
+    Reader.join();
+  }
+  EXPECT_FALSE(Failed);
+}
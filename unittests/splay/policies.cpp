@@ -0,0 +1,626 @@
+#include "hammock/impl/splay.hpp"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <type_traits>
+
+using namespace hammock;
+
+template <class Policy>
+using PolicyTree =
+    impl::SplayTree<int, int, std::less<int>,
+                    std::allocator<std::pair<int, int>>, Policy>;
+
+template <class Tree> class SplayPolicyTest : public ::testing::Test {};
+
+using Policies =
+    ::testing::Types<PolicyTree<policy::BottomUp>, PolicyTree<policy::TopDown>,
+                     PolicyTree<policy::Probabilistic>,
+                     PolicyTree<policy::SemiSplay>,
+                     PolicyTree<policy::DepthThreshold>,
+                     PolicyTree<policy::Counter>>;
+TYPED_TEST_SUITE(SplayPolicyTest, Policies);
+
+/// True if the policy always brings the accessed node to the root.
+template <class Tree>
+constexpr bool SplaysToRoot =
+    std::is_same_v<typename Tree::splay_policy, policy::BottomUp> or
+    std::is_same_v<typename Tree::splay_policy, policy::TopDown>;
+
+template <class Tree>
+void checkEqual(const std::map<int, int> &Standard, const Tree &Actual) {
+  EXPECT_EQ(Standard.size(), Actual.size());
+  ASSERT_TRUE(std::equal(Standard.begin(), Standard.end(), Actual.begin(),
+                         Actual.end()));
+  ASSERT_TRUE(std::equal(Standard.rbegin(), Standard.rend(), Actual.rbegin(),
+                         Actual.rend()));
+}
+
+TYPED_TEST(SplayPolicyTest, InsertTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 1000; ++i) {
+    int Key = Random() % 500;
+    auto [StandardIt, StandardInserted] = Standard.insert({Key, i});
+    auto [TreeIt, TreeInserted] = Tree.insert({Key, i});
+
+    EXPECT_EQ(StandardInserted, TreeInserted);
+    EXPECT_EQ(*StandardIt, *TreeIt);
+  }
+  checkEqual(Standard, Tree);
+
+  // The key of the root is the first one the search meets
+  for (int Key : {1000, 1001}) {
+    EXPECT_TRUE(Tree.insert({Key, 0}).second);
+    if constexpr (SplaysToRoot<TypeParam>) {
+      EXPECT_EQ(Key, Tree.pre_begin()->first);
+    }
+    auto [TreeIt, TreeInserted] = Tree.insert({Key, 1});
+    EXPECT_FALSE(TreeInserted);
+    EXPECT_EQ(Key, TreeIt->first);
+    EXPECT_EQ(0, TreeIt->second);
+  }
+  EXPECT_EQ(Standard.size() + 2, Tree.size());
+}
+
+TYPED_TEST(SplayPolicyTest, FindTest) {
+  TypeParam Tree;
+  for (int i = 0; i < 100; ++i) {
+    Tree.insert({i * 2, i});
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    auto It = Tree.find(i * 2);
+    ASSERT_NE(It, Tree.end());
+    EXPECT_EQ(It->second, i);
+    EXPECT_EQ(Tree.find(i * 2 + 1), Tree.end());
+    EXPECT_EQ(Tree.find(-i - 1), Tree.end());
+  }
+  EXPECT_EQ(Tree.size(), 100);
+  EXPECT_EQ(Tree.begin()->first, 0);
+  EXPECT_EQ(Tree.rbegin()->first, 198);
+}
+
+TYPED_TEST(SplayPolicyTest, EraseTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 1000; ++i) {
+    int Key = Random() % 500;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+  }
+
+  while (not Standard.empty()) {
+    int Key = std::next(Standard.begin(), Random() % Standard.size())->first;
+    auto StandardIt = Standard.erase(Standard.find(Key));
+    auto TreeIt = Tree.erase(Tree.find(Key));
+
+    if (StandardIt == Standard.end()) {
+      EXPECT_EQ(TreeIt, Tree.end());
+    } else {
+      EXPECT_EQ(TreeIt->first, StandardIt->first);
+    }
+    checkEqual(Standard, Tree);
+  }
+  EXPECT_TRUE(Tree.empty());
+}
+
+TYPED_TEST(SplayPolicyTest, EraseKeyAndRangeTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 3000; ++i) {
+    const int Key = Random() % 1000;
+    switch (Random() % 4) {
+    case 0:
+      EXPECT_EQ(Standard.erase(Key), Tree.erase(Key));
+      break;
+    case 1: {
+      const int Upper = Key + Random() % 50;
+      auto StandardIt = Standard.erase(Standard.lower_bound(Key),
+                                       Standard.lower_bound(Upper));
+      auto TreeIt = Tree.erase(Tree.lower_bound(Key), Tree.lower_bound(Upper));
+      if (StandardIt == Standard.end()) {
+        EXPECT_EQ(Tree.end(), TreeIt);
+      } else {
+        ASSERT_NE(Tree.end(), TreeIt);
+        EXPECT_EQ(StandardIt->first, TreeIt->first);
+      }
+      break;
+    }
+    default:
+      Tree.insert({Key, i});
+      Standard.insert({Key, i});
+    }
+    ASSERT_EQ(Standard.size(), Tree.size());
+  }
+  checkEqual(Standard, Tree);
+
+  // Ranges at both ends move the shortcuts
+  Tree.erase(Tree.begin(), Tree.lower_bound(100));
+  Standard.erase(Standard.begin(), Standard.lower_bound(100));
+  Tree.erase(Tree.lower_bound(900), Tree.end());
+  Standard.erase(Standard.lower_bound(900), Standard.end());
+  checkEqual(Standard, Tree);
+
+  EXPECT_EQ(Tree.begin(), Tree.erase(Tree.begin(), Tree.begin()));
+  EXPECT_EQ(Tree.end(), Tree.erase(Tree.begin(), Tree.end()));
+  EXPECT_TRUE(Tree.empty());
+  EXPECT_EQ(0, Tree.erase(42));
+}
+
+TYPED_TEST(SplayPolicyTest, SplitAndJoinTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 500; ++i) {
+    int Key = Random() % 1000;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+  }
+
+  for (int Key : {-1, 0, 1, 250, 500, 501, 998, 999, 1000}) {
+    auto Upper = Tree.split(Key);
+    std::map<int, int> StandardUpper(Standard.lower_bound(Key),
+                                     Standard.end());
+    std::map<int, int> StandardLower(Standard.begin(),
+                                     Standard.lower_bound(Key));
+    checkEqual(StandardLower, Tree);
+    checkEqual(StandardUpper, Upper);
+
+    // both parts are still valid trees
+    Upper.insert({2000, 0});
+    Upper.erase(Upper.find(2000));
+    Tree.insert({-2000, 0});
+    Tree.erase(Tree.find(-2000));
+
+    Tree.join(std::move(Upper));
+    EXPECT_TRUE(Upper.empty());
+    EXPECT_EQ(Upper.begin(), Upper.end());
+    checkEqual(Standard, Tree);
+  }
+
+  TypeParam Empty;
+  Empty.join(Tree.split(-1));
+  EXPECT_TRUE(Tree.empty());
+  checkEqual(Standard, Empty);
+}
+
+TYPED_TEST(SplayPolicyTest, BoundsTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 300; ++i) {
+    int Key = Random() % 1000;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+  }
+
+  auto Check = [&Tree, &Standard](auto TreeIt, auto StandardIt) {
+    if (StandardIt == Standard.end()) {
+      EXPECT_EQ(TreeIt, Tree.end());
+    } else {
+      ASSERT_NE(TreeIt, Tree.end());
+      EXPECT_EQ(*StandardIt, *TreeIt);
+    }
+  };
+
+  for (int i = 0; i < 2000; ++i) {
+    int Key = Random() % 1100 - 50;
+    Check(Tree.lower_bound(Key), Standard.lower_bound(Key));
+    Check(Tree.upper_bound(Key), Standard.upper_bound(Key));
+
+    auto [TreeFirst, TreeLast] = Tree.equal_range(Key);
+    auto [StandardFirst, StandardLast] = Standard.equal_range(Key);
+    Check(TreeFirst, StandardFirst);
+    Check(TreeLast, StandardLast);
+    EXPECT_EQ(std::distance(StandardFirst, StandardLast),
+              std::distance(TreeFirst, TreeLast));
+  }
+  checkEqual(Standard, Tree);
+}
+
+TYPED_TEST(SplayPolicyTest, MissSplaysTest) {
+  if constexpr (not SplaysToRoot<TypeParam>) {
+    GTEST_SKIP() << "The policy doesn't always splay to the root";
+  }
+  TypeParam Tree;
+  // Sequential insertions make a long path
+  for (int i = 0; i < 1000; ++i) {
+    Tree.insert({i * 2, i});
+  }
+
+  for (int Key : {1, 501, 999, 1997, -1, 1999}) {
+    EXPECT_EQ(Tree.end(), Tree.find(Key));
+    // The root is one of the neighbors of the missing key
+    const int Root = Tree.pre_begin()->first;
+    EXPECT_TRUE(Root == Key - 1 or Root == Key + 1) << Key << " " << Root;
+  }
+  EXPECT_EQ(1000, std::distance(Tree.begin(), Tree.end()));
+}
+
+TYPED_TEST(SplayPolicyTest, StatisticsTest) {
+  impl::SplayTree<int, int, std::less<int>,
+                  std::allocator<std::pair<int, int>>,
+                  policy::WithStatistics<typename TypeParam::splay_policy>>
+      Tree;
+  EXPECT_FALSE(Tree.contains(0));
+  for (int i = 0; i < 100; ++i) {
+    Tree.insert({i * 2, i});
+  }
+  for (int i = 0; i < 100; ++i) {
+    Tree.find(i);
+  }
+  EXPECT_EQ(50, Tree.get_splay_policy().hits());
+  EXPECT_EQ(51, Tree.get_splay_policy().misses());
+  EXPECT_EQ(101, Tree.get_splay_policy().lookups());
+
+  // The policy goes wherever the nodes go
+  decltype(Tree) Assigned, Moved;
+  Assigned = Tree;
+  EXPECT_EQ(101, Assigned.get_splay_policy().lookups());
+  Moved = std::move(Assigned);
+  EXPECT_EQ(101, Moved.get_splay_policy().lookups());
+  decltype(Tree) Swapped;
+  std::swap(Moved, Swapped);
+  EXPECT_EQ(101, Swapped.get_splay_policy().lookups());
+  EXPECT_EQ(0, Moved.get_splay_policy().lookups());
+  EXPECT_EQ(101, Tree.split(100).get_splay_policy().lookups());
+}
+
+TYPED_TEST(SplayPolicyTest, ConstAndFrozenLookupTest) {
+  TypeParam Tree;
+  for (int i = 0; i < 100; ++i) {
+    Tree.insert({i * 2, i});
+  }
+  const int Root = Tree.pre_begin()->first;
+
+  const auto &ConstTree = Tree;
+  for (int i = -1; i < 201; ++i) {
+    auto It = ConstTree.find(i);
+    EXPECT_EQ(i % 2 == 0 and i >= 0 and i < 200, It != ConstTree.end());
+    EXPECT_EQ(It != ConstTree.end(), ConstTree.contains(i));
+    EXPECT_EQ(It != ConstTree.end(), ConstTree.count(i));
+
+    auto Lower = ConstTree.lower_bound(i), Upper = ConstTree.upper_bound(i);
+    if (i < 198) {
+      EXPECT_EQ((i + 1) / 2 * 2, Lower->first);
+      EXPECT_EQ((i + 2) / 2 * 2, Upper->first);
+    }
+    EXPECT_EQ(std::make_pair(Lower, Upper), ConstTree.equal_range(i));
+  }
+  EXPECT_EQ(25, ConstTree.at(50));
+  EXPECT_THROW(ConstTree.at(51), std::out_of_range);
+  EXPECT_EQ(Root, Tree.pre_begin()->first);
+
+  Tree.freeze();
+  EXPECT_TRUE(Tree.frozen());
+  EXPECT_EQ(10, Tree.find(20)->second);
+  EXPECT_EQ(Tree.end(), Tree.find(21));
+  EXPECT_EQ(22, Tree.lower_bound(21)->first);
+  EXPECT_EQ(22, Tree.upper_bound(20)->first);
+  EXPECT_EQ(Root, Tree.pre_begin()->first);
+
+  Tree.freeze(false);
+  Tree.find(20);
+  if constexpr (SplaysToRoot<TypeParam>) {
+    EXPECT_EQ(20, Tree.pre_begin()->first);
+  }
+}
+
+TEST(SplayPolicyTest, PartialSplayingTest) {
+  PolicyTree<policy::SemiSplay> SemiSplayed;
+  PolicyTree<policy::DepthThreshold> Thresholded{policy::DepthThreshold{8}};
+  PolicyTree<policy::Probabilistic> Never{policy::Probabilistic{0}};
+  // Sequential insertions without splaying make a long left path
+  for (int i = 1000; i > 0; --i) {
+    Never.insert({i, i});
+  }
+  for (int i = 0; i < 1000; ++i) {
+    SemiSplayed.insert({i, i});
+    Thresholded.insert({i, i});
+  }
+  EXPECT_EQ(1000, Never.pre_begin()->first);
+
+  // Parts of the tree, copies and swapped trees don't splay either
+  auto Upper = Never.split(500);
+  Upper.find(1000);
+  EXPECT_EQ(500, Upper.pre_begin()->first);
+  PolicyTree<policy::Probabilistic> Swapped;
+  std::swap(Swapped, Never);
+  Swapped.find(1);
+  EXPECT_EQ(499, Swapped.pre_begin()->first);
+
+  // Repeated accesses to the same node bring it to the top
+  for (int i = 0; i < 20; ++i) {
+    SemiSplayed.find(0);
+  }
+  EXPECT_EQ(0, SemiSplayed.pre_begin()->first);
+
+  // ...but nodes above the threshold are left alone
+  Thresholded.find(0);
+  const int Root = Thresholded.pre_begin()->first;
+  const int Child = std::next(Thresholded.pre_begin())->first;
+  Thresholded.find(Child);
+  EXPECT_EQ(Root, Thresholded.pre_begin()->first);
+}
+
+TYPED_TEST(SplayPolicyTest, BatchLookupTest) {
+  TypeParam Tree;
+  std::mt19937 Random{42};
+  for (int i = 0; i < 1000; ++i) {
+    Tree.insert({Random() % 2000, i});
+  }
+
+  std::vector<int> Keys;
+  for (int i = 0; i < 301; ++i) {
+    Keys.push_back(Random() % 2100 - 50);
+  }
+
+  std::vector<typename TypeParam::iterator> Found;
+  std::vector<bool> Contained;
+  Tree.find_batch(Keys.begin(), Keys.end(), std::back_inserter(Found));
+  Tree.contains_batch(Keys.begin(), Keys.end(),
+                      std::back_inserter(Contained));
+  ASSERT_EQ(Keys.size(), Found.size());
+  ASSERT_EQ(Keys.size(), Contained.size());
+
+  const auto &ConstTree = Tree;
+  for (std::size_t i = 0; i < Keys.size(); ++i) {
+    auto Expected = ConstTree.find(Keys[i]);
+    EXPECT_EQ(Expected != ConstTree.end(), Contained[i]);
+    if (Expected == ConstTree.end()) {
+      EXPECT_EQ(Tree.end(), Found[i]);
+    } else {
+      ASSERT_NE(Tree.end(), Found[i]);
+      EXPECT_EQ(*Expected, *Found[i]);
+    }
+  }
+  // Splaying after the batch keeps the tree intact
+  EXPECT_EQ(Tree.size(), std::distance(Tree.begin(), Tree.end()));
+  EXPECT_TRUE(std::is_sorted(Tree.begin(), Tree.end()));
+}
+
+TYPED_TEST(SplayPolicyTest, BatchInsertAndEraseTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int Round = 0; Round < 10; ++Round) {
+    // Batches have duplicates of their own and of the keys from the tree
+    std::vector<std::pair<int, int>> Batch;
+    for (int i = 0; i < 200; ++i) {
+      Batch.emplace_back(Random() % 3000, Round * 1000 + i);
+    }
+    Tree.insert(Batch.begin(), Batch.end());
+    Standard.insert(Batch.begin(), Batch.end());
+    checkEqual(Standard, Tree);
+
+    std::vector<int> Keys;
+    for (int i = 0; i < 100; ++i) {
+      Keys.push_back(Random() % 3000);
+    }
+    std::size_t Expected = 0;
+    for (int Key : Keys) {
+      Expected += Standard.erase(Key);
+    }
+    EXPECT_EQ(Expected, Tree.erase_keys(Keys.begin(), Keys.end()));
+    checkEqual(Standard, Tree);
+  }
+
+  // Grafted sub-trees are wired into the tree properly
+  for (auto &[Key, Value] : Standard) {
+    ASSERT_NE(Tree.end(), Tree.find(Key));
+    EXPECT_EQ(Value, Tree.find(Key)->second);
+  }
+  checkEqual(Standard, Tree);
+
+  TypeParam Empty;
+  std::vector<std::pair<int, int>> Nothing;
+  Empty.insert(Nothing.begin(), Nothing.end());
+  EXPECT_TRUE(Empty.empty());
+  std::vector<int> NoKeys;
+  EXPECT_EQ(0, Empty.erase_keys(NoKeys.begin(), NoKeys.end()));
+}
+
+TYPED_TEST(SplayPolicyTest, HintInsertTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+
+  // Appends and prepends through the shortcuts
+  for (int i = 0; i < 100; ++i) {
+    auto It = Tree.insert(Tree.end(), {1000 + i, i});
+    EXPECT_EQ(1000 + i, It->first);
+    It = Tree.emplace_hint(Tree.begin(), 1000 - i - 1, i);
+    EXPECT_EQ(1000 - i - 1, It->first);
+    Standard.emplace(1000 + i, i);
+    Standard.emplace(1000 - i - 1, i);
+  }
+  checkEqual(Standard, Tree);
+
+  // Insertions right after the previous one
+  auto Previous = Tree.find(1100 - 1);
+  for (int i = 0; i < 50; ++i) {
+    Previous = Tree.try_emplace(Previous, 2000 + 2 * i, i).first;
+    Standard.emplace(2000 + 2 * i, i);
+  }
+  checkEqual(Standard, Tree);
+
+  std::mt19937 Random{42};
+  for (int i = 0; i < 1000; ++i) {
+    const int Key = Random() % 3000;
+    // Accurate, slightly off and completely wrong hints
+    typename TypeParam::const_iterator Hint = Tree.lower_bound(Key);
+    if (i % 3 == 1 and Hint != Tree.begin()) {
+      --Hint;
+    } else if (i % 3 == 2) {
+      Hint = Tree.find(Random() % 3000);
+    }
+    const auto StandardResult = Standard.emplace(Key, i);
+    auto It = Tree.insert(Hint, {Key, i});
+    ASSERT_NE(Tree.end(), It);
+    EXPECT_EQ(*StandardResult.first, *It);
+  }
+  checkEqual(Standard, Tree);
+
+  for (auto &[Key, Value] : Standard) {
+    ASSERT_NE(Tree.end(), Tree.find(Key));
+    EXPECT_EQ(Value, Tree.find(Key)->second);
+  }
+
+  // Frozen trees grow at both ends without splaying
+  TypeParam Frozen;
+  Frozen.freeze();
+  Frozen.insert({0, 0});
+  for (int i = 1; i < 1000; ++i) {
+    EXPECT_EQ(-i, Frozen.insert(Frozen.begin(), {-i, i})->first);
+    EXPECT_EQ(i, Frozen.insert(Frozen.end(), {i, i})->first);
+  }
+  EXPECT_EQ(0, Frozen.pre_begin()->first);
+  EXPECT_EQ(1999, Frozen.size());
+  int Expected = -999;
+  for (auto &[Key, Value] : Frozen) {
+    EXPECT_EQ(Expected++, Key);
+  }
+}
+
+TYPED_TEST(SplayPolicyTest, NodeHandleTest) {
+  TypeParam Tree, Other;
+  std::map<int, int> Standard, OtherStandard;
+  for (int i = 0; i < 200; ++i) {
+    Tree.insert({i, i});
+    Standard.emplace(i, i);
+  }
+
+  EXPECT_TRUE(Tree.extract(1000).empty());
+  EXPECT_TRUE(Tree.extract(Tree.end()).empty());
+
+  std::mt19937 Random{42};
+  for (int i = 0; i < 300; ++i) {
+    const int Key = Random() % 200;
+    auto Handle =
+        i % 2 ? Tree.extract(Key) : Tree.extract(Tree.lower_bound(Key));
+    if (Handle.empty()) {
+      continue;
+    }
+    const int Extracted = Handle.key();
+    const auto *Address = &Handle.mapped();
+    Standard.erase(Extracted);
+    Handle.mapped() = -Extracted;
+
+    // Nodes move between the trees without reallocation
+    auto [Position, Inserted, Node] = Other.insert(std::move(Handle));
+    EXPECT_TRUE(Inserted);
+    EXPECT_TRUE(Node.empty());
+    EXPECT_EQ(Address, &Position->second);
+    OtherStandard.emplace(Extracted, -Extracted);
+  }
+  checkEqual(Standard, Tree);
+  checkEqual(OtherStandard, Other);
+
+  // Keys can be changed while nodes are out of the tree
+  auto Handle = Other.extract(Other.begin());
+  const int Key = Handle.key();
+  Handle.key() = Standard.begin()->first;
+  auto Result = Tree.insert(std::move(Handle));
+  EXPECT_FALSE(Result.inserted);
+  ASSERT_FALSE(Result.node.empty());
+  EXPECT_EQ(Tree.begin(), Result.position);
+  Result.node.key() = Key;
+  EXPECT_NE(Tree.end(), Tree.insert(Tree.end(), std::move(Result.node)));
+  Standard.emplace(Key, -Key);
+  OtherStandard.erase(Key);
+  checkEqual(Standard, Tree);
+
+  std::vector<const int *> Addresses;
+  for (auto &Pair : Other) {
+    Addresses.push_back(&Pair.second);
+  }
+  Other.insert({Standard.begin()->first, 0});
+  OtherStandard.emplace(Standard.begin()->first, 0);
+  Tree.merge(Other);
+  Standard.merge(OtherStandard);
+  checkEqual(Standard, Tree);
+  checkEqual(OtherStandard, Other);
+  for (const auto *Address : Addresses) {
+    EXPECT_EQ(Address, &Tree.find(-*Address)->second);
+  }
+}
+
+TYPED_TEST(SplayPolicyTest, ForEachTest) {
+  TypeParam Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+  for (int i = 0; i < 1000; ++i) {
+    const int Key = Random() % 2000;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+    // Lookups change the shape of the tree between the scans
+    Tree.find(Random() % 2000);
+
+    if (i % 100 == 0) {
+      std::vector<std::pair<const int, int>> Visited;
+      Tree.for_each([&Visited](const auto &Pair) { Visited.push_back(Pair); });
+      ASSERT_TRUE(std::equal(Standard.begin(), Standard.end(),
+                             Visited.begin(), Visited.end()));
+    }
+  }
+
+  for (int i = 0; i < 50; ++i) {
+    const int Lower = Random() % 2000, Upper = Lower + Random() % 300;
+    std::vector<std::pair<const int, int>> Visited;
+    Tree.for_each(Tree.lower_bound(Lower), Tree.lower_bound(Upper),
+                  [&Visited](const auto &Pair) { Visited.push_back(Pair); });
+    ASSERT_TRUE(std::equal(Standard.lower_bound(Lower),
+                           Standard.lower_bound(Upper), Visited.begin(),
+                           Visited.end()));
+  }
+
+  // Chunks of any size add up to the whole tree
+  for (std::size_t Capacity : {1, 7, 64, 5000}) {
+    std::vector<const std::pair<const int, int> *> Buffer(Capacity);
+    std::vector<std::pair<const int, int>> Gathered;
+    typename TypeParam::const_iterator From = Tree.begin();
+    while (std::size_t Count =
+               Tree.gather(From, Tree.end(), Buffer.data(), Capacity)) {
+      EXPECT_TRUE(Count == Capacity or From == Tree.end());
+      for (std::size_t j = 0; j < Count; ++j) {
+        Gathered.push_back(*Buffer[j]);
+      }
+    }
+    EXPECT_EQ(Tree.end(), From);
+    ASSERT_TRUE(std::equal(Standard.begin(), Standard.end(),
+                           Gathered.begin(), Gathered.end()));
+  }
+
+  // Left spines of degenerate trees are longer than the scan keeps
+  TypeParam Path;
+  for (int i = 0; i < 500; ++i) {
+    Path.insert({i, i});
+  }
+  for (int Key : {0, 250}) {
+    Path.find(Key);
+    int Expected = 0;
+    Path.for_each([&Expected](const auto &Pair) {
+      EXPECT_EQ(Expected++, Pair.first);
+    });
+    EXPECT_EQ(500, Expected);
+  }
+
+  typename TypeParam::const_iterator From = Tree.find(Standard.begin()->first);
+  typename TypeParam::const_iterator Last = std::next(From, 3);
+  const std::pair<const int, int> *Buffer[10];
+  EXPECT_EQ(3, Tree.gather(From, Last, Buffer, 10));
+  EXPECT_EQ(Last, From);
+  EXPECT_EQ(0, Tree.gather(From, Last, Buffer, 10));
+}
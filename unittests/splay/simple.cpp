@@ -3,9 +3,18 @@
 #include <gtest/gtest.h>
 #include <iterator>
 #include <limits.h>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
 
 using namespace hammock::impl;
 
+static_assert(sizeof(SplayTree<int, int>::Node) ==
+                  3 * sizeof(void *) + sizeof(std::pair<int, int>),
+              "Nodes should have no other fields, but three pointers");
+
 unsigned insertTypicalSequence(SplayTree<int, int> &Tree) {
   unsigned ExpectedSize = 0;
   EXPECT_TRUE(Tree.empty());
@@ -75,6 +84,64 @@ TEST(SplayTest, RepeatingInitializationTest) {
       << "Found mismatch at " << TreeIt->first << " : " << TreeIt->second;
 }
 
+TEST(SplayTest, RangeInitializationTest) {
+  std::vector<std::pair<int, int>> Sorted, Shuffled;
+  for (int i = 0; i < 1000; ++i) {
+    Sorted.emplace_back(i, -i);
+  }
+  Shuffled = Sorted;
+  std::shuffle(Shuffled.begin(), Shuffled.end(), std::mt19937{42});
+  // equivalent keys go after the original ones and should be ignored
+  for (int i = 0; i < 1000; i += 3) {
+    Shuffled.emplace_back(i, i);
+  }
+  std::map<int, int> Standard(Sorted.begin(), Sorted.end());
+
+  SplayTree<int, int> FromSorted(Sorted.begin(), Sorted.end());
+  SplayTree<int, int> FromShuffled(Shuffled.begin(), Shuffled.end());
+  SplayTree<int, int> FromTagged(hammock::sorted_unique, Standard.begin(),
+                                 Standard.end());
+  // sorted input builds a balanced tree with the median in the root
+  EXPECT_EQ(499, FromSorted.pre_begin()->first);
+
+  for (auto *Tree : {&FromSorted, &FromShuffled, &FromTagged}) {
+    EXPECT_EQ(Standard.size(), Tree->size());
+    EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Tree->begin(),
+                           Tree->end()));
+    EXPECT_TRUE(std::equal(Standard.rbegin(), Standard.rend(), Tree->rbegin(),
+                           Tree->rend()));
+    EXPECT_EQ(-500, Tree->at(500));
+    Tree->erase(Tree->find(0));
+    EXPECT_EQ(1, Tree->begin()->first);
+  }
+
+  FromSorted.assign(Shuffled.begin(), Shuffled.begin() + 10);
+  EXPECT_EQ(10, FromSorted.size());
+  FromSorted.assign(Sorted.begin(), Sorted.begin());
+  EXPECT_TRUE(FromSorted.empty());
+  EXPECT_EQ(FromSorted.begin(), FromSorted.end());
+}
+
+TEST(SplayTest, HeterogeneousBoundsTest) {
+  SplayTree<std::string, int, std::less<>> Tree;
+  for (auto Key : {"apple", "banana", "cherry", "date"}) {
+    Tree.insert({Key, 0});
+  }
+
+  std::string_view Prefix = "b";
+  auto First = Tree.lower_bound(Prefix), Last = Tree.upper_bound("c");
+  ASSERT_NE(First, Tree.end());
+  EXPECT_EQ("banana", First->first);
+  ASSERT_NE(Last, Tree.end());
+  EXPECT_EQ("cherry", Last->first);
+  EXPECT_EQ(1, std::distance(First, Last));
+
+  auto [Begin, End] = Tree.equal_range("date");
+  EXPECT_EQ("date", Begin->first);
+  EXPECT_EQ(Tree.end(), End);
+  EXPECT_EQ(Tree.end(), Tree.lower_bound("elderberry"));
+}
+
 TEST(SplayTest, EraseTest) {
   SplayTree<int, std::string> Tree = {{1, "hello"}, {3, "world"}, {4, "!"}};
 
@@ -111,6 +178,36 @@ TEST(SplayTest, EraseTest) {
   EXPECT_EQ(NewRootValue, "hello, world!");
 }
 
+TEST(SplayTest, EraseEverythingTest) {
+  SplayTree<int, int> Tree;
+  std::map<int, int> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 1000; ++i) {
+    int Key = Random() % 500;
+    Tree.insert({Key, i});
+    Standard.insert({Key, i});
+  }
+
+  while (not Standard.empty()) {
+    auto Index = Random() % Standard.size();
+    auto StandardIt = Standard.erase(std::next(Standard.begin(), Index));
+    auto TreeIt = Tree.erase(std::next(Tree.begin(), Index));
+
+    EXPECT_EQ(Tree.size(), Standard.size());
+    if (StandardIt == Standard.end()) {
+      EXPECT_EQ(TreeIt, Tree.end());
+    } else {
+      EXPECT_EQ(TreeIt->first, StandardIt->first);
+    }
+    ASSERT_TRUE(std::equal(Standard.begin(), Standard.end(), Tree.begin(),
+                           Tree.end()));
+    ASSERT_TRUE(std::equal(Standard.rbegin(), Standard.rend(), Tree.rbegin(),
+                           Tree.rend()));
+  }
+  EXPECT_TRUE(Tree.empty());
+}
+
 TEST(SplayTest, InsertUniqueTest) {
   SplayTree<int, unsigned> Tree;
   std::vector Source = {1, 42, 52, 1, 2, 2, 42, 0, -1, 38, 1, 0, 0, 0};
@@ -308,3 +405,16 @@ TEST(SplayTest, PreOrderTest) {
   EXPECT_EQ(CopyIt, Copy.end());
   EXPECT_EQ(TreeIt, Tree.end());
 }
+
+TEST(SplayTest, EmptyTraversalTest) {
+  SplayTree<int, int> Tree;
+  EXPECT_EQ(Tree.begin(), Tree.end());
+  EXPECT_EQ(Tree.pre_begin(), Tree.pre_end());
+  EXPECT_EQ(Tree.post_begin(), Tree.post_end());
+
+  Tree.insert({1, 1});
+  Tree.erase(Tree.begin());
+  EXPECT_EQ(Tree.begin(), Tree.end());
+  EXPECT_EQ(Tree.pre_begin(), Tree.pre_end());
+  EXPECT_EQ(Tree.post_begin(), Tree.post_end());
+}
@@ -0,0 +1,242 @@
+#include "hammock/impl/compact_splay.hpp"
+#include "hammock/impl/splay.hpp"
+#include "hammock/utils/pool.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace hammock;
+
+template <class ValueType>
+using PoolTree =
+    impl::SplayTree<int, ValueType, std::less<int>,
+                    utils::PoolAllocator<std::pair<const int, ValueType>>>;
+
+TEST(PoolAllocatorTest, ReuseTest) {
+  utils::PoolAllocator<long> Allocator;
+  std::set<long *> Allocated;
+
+  for (int i = 0; i < 1000; ++i) {
+    Allocated.insert(Allocator.allocate(1));
+  }
+  EXPECT_EQ(1000, Allocated.size());
+  EXPECT_EQ(1000, Allocator.allocated());
+
+  // freed slots are the first to be reused
+  auto *Freed = *Allocated.begin();
+  Allocator.deallocate(Freed, 1);
+  EXPECT_EQ(999, Allocator.allocated());
+  EXPECT_EQ(Freed, Allocator.allocate(1));
+
+  // arrays don't come from the pool
+  auto *Array = Allocator.allocate(10);
+  Allocator.deallocate(Array, 10);
+  EXPECT_EQ(1000, Allocator.allocated());
+
+  for (auto *Pointer : Allocated) {
+    Allocator.deallocate(Pointer, 1);
+  }
+  EXPECT_EQ(0, Allocator.allocated());
+}
+
+TEST(PoolAllocatorTest, ReserveTest) {
+  utils::PoolAllocator<long> Allocator;
+  // put something into the free list, reserved slots should ignore it
+  Allocator.deallocate(Allocator.allocate(1), 1);
+
+  Allocator.reserve(1000);
+  auto *First = Allocator.allocate(1);
+  for (int i = 1; i < 1000; ++i) {
+    EXPECT_EQ(First + i, Allocator.allocate(1));
+  }
+  Allocator.release();
+  EXPECT_EQ(0, Allocator.allocated());
+}
+
+TEST(PoolAllocatorTest, RebindTest) {
+  utils::PoolAllocator<int> Allocator;
+  utils::PoolAllocator<std::string> Rebound{Allocator};
+  EXPECT_EQ(Allocator, Rebound);
+  EXPECT_NE(Allocator, utils::PoolAllocator<int>{});
+  EXPECT_NE(Allocator, std::allocator_traits<utils::PoolAllocator<int>>::
+                           select_on_container_copy_construction(Allocator));
+
+  // the first single-object allocation decides what the pool is for
+  auto *String = Rebound.allocate(1);
+  auto *Integer = Allocator.allocate(1);
+  EXPECT_EQ(1, Rebound.allocated());
+  Allocator.deallocate(Integer, 1);
+  Rebound.deallocate(String, 1);
+  EXPECT_EQ(0, Rebound.allocated());
+}
+
+TEST(PoolAllocatorTest, SplayTreeTest) {
+  PoolTree<std::string> Tree;
+  std::map<int, std::string> Standard;
+  std::mt19937 Random{42};
+
+  for (int i = 0; i < 5000; ++i) {
+    int Key = Random() % 1000;
+    if (Random() % 3 == 0) {
+      EXPECT_EQ(Standard.erase(Key), Tree.contains(Key));
+      Tree.erase(Tree.find(Key));
+    } else {
+      auto Value = std::to_string(i) + " is a long enough string to allocate";
+      EXPECT_EQ(Standard.insert({Key, Value}).second,
+                Tree.insert({Key, Value}).second);
+    }
+  }
+  ASSERT_EQ(Standard.size(), Tree.size());
+  EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Tree.begin(),
+                         Tree.end()));
+
+  // copies have their own pools
+  auto Copy = Tree;
+  EXPECT_TRUE(
+      std::equal(Copy.begin(), Copy.end(), Tree.begin(), Tree.end()));
+  Tree.clear();
+  EXPECT_EQ(Standard.size(), Copy.size());
+
+  Tree = std::move(Copy);
+  EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Tree.begin(),
+                         Tree.end()));
+
+  Copy = Tree;
+  Copy = std::move(Tree);
+  EXPECT_TRUE(Tree.empty());
+  EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Copy.begin(),
+                         Copy.end()));
+}
+
+TEST(PoolAllocatorTest, CompactSplayTreeTest) {
+  impl::CompactSplayTree<int, std::string, std::less<int>,
+                         utils::PoolAllocator<std::pair<const int, int>>>
+      Tree;
+  for (int i = 0; i < 1000; ++i) {
+    Tree.try_emplace(i * 7 % 1000, 10, 'a');
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    Tree.erase(Tree.find(i));
+  }
+  auto Copy = Tree;
+  EXPECT_EQ(500, Copy.size());
+  EXPECT_TRUE(std::equal(Copy.begin(), Copy.end(), Tree.begin(), Tree.end()));
+}
+
+TEST(PoolAllocatorTest, BulkReleaseTest) {
+  PoolTree<int> Tree;
+  for (int i = 0; i < 1000; ++i) {
+    Tree.insert({i * 31 % 1000, i});
+  }
+
+  // the moved-from tree shares the arena with the new one
+  PoolTree<int> Other{std::move(Tree)};
+  for (int i = 0; i < 10; ++i) {
+    Tree.insert({i, i});
+  }
+
+  // so it can't be released at once
+  Tree.clear();
+  EXPECT_TRUE(Tree.empty());
+  EXPECT_EQ(1000, Other.size());
+  EXPECT_EQ(999, Other.find(999)->first);
+
+  Other.clear();
+  EXPECT_TRUE(Other.empty());
+  Other.insert({42, 42});
+  EXPECT_EQ(1, Other.size());
+  EXPECT_EQ(42, Other.begin()->second);
+}
+
+TEST(PoolAllocatorTest, ContiguousBuildTest) {
+  std::vector<std::pair<int, int>> Sorted;
+  for (int i = 0; i < 1000; ++i) {
+    Sorted.emplace_back(i, i);
+  }
+  PoolTree<int> Tree(hammock::sorted_unique, Sorted.begin(), Sorted.end());
+
+  // nodes are allocated in-order one after another
+  using Node = PoolTree<int>::Node;
+  const auto *Previous = reinterpret_cast<const char *>(&*Tree.begin());
+  for (auto It = std::next(Tree.begin()); It != Tree.end(); ++It) {
+    const auto *Current = reinterpret_cast<const char *>(&*It);
+    EXPECT_EQ(sizeof(Node), Current - Previous);
+    Previous = Current;
+  }
+}
+
+TEST(PoolAllocatorTest, ContiguousCopyTest) {
+  std::mt19937 Generator(7);
+  std::uniform_int_distribution<int> Keys(0, 10000);
+  PoolTree<int> Tree;
+  for (int i = 0; i < 1000; ++i) {
+    Tree.insert({Keys(Generator), i});
+  }
+  // spread the nodes of the original all over the arena
+  for (int i = 0; i < 300; ++i) {
+    if (auto It = Tree.find(Keys(Generator)); It != Tree.end()) {
+      Tree.erase(It);
+    }
+    Tree.insert({Keys(Generator), i});
+  }
+
+  auto Check = [&Tree](const PoolTree<int> &Copy) {
+    ASSERT_TRUE(
+        std::equal(Copy.begin(), Copy.end(), Tree.begin(), Tree.end()));
+    // nodes of the copy are allocated in one block
+    using Node = PoolTree<int>::Node;
+    std::vector<const char *> Addresses;
+    for (const auto &Element : Copy) {
+      Addresses.push_back(reinterpret_cast<const char *>(&Element));
+    }
+    std::sort(Addresses.begin(), Addresses.end());
+    EXPECT_EQ(sizeof(Node) * (Copy.size() - 1),
+              Addresses.back() - Addresses.front());
+  };
+
+  const PoolTree<int> Copy = Tree;
+  Check(Copy);
+
+  PoolTree<int> Assigned;
+  Assigned.insert({1, 1});
+  Assigned = Tree;
+  Check(Assigned);
+}
+
+TEST(PoolAllocatorTest, MergeTest) {
+  using Tree = PoolTree<std::string>;
+  Tree Target, Separate;
+  Tree Shared(std::less<int>{}, Target.get_allocator());
+  for (int i = 0; i < 100; ++i) {
+    Target.insert({i * 3, "target"});
+    Shared.insert({i * 2, "shared"});
+    Separate.insert({i * 5, "separate"});
+  }
+  auto Allocator = Target.get_allocator();
+  EXPECT_EQ(200, Allocator.allocated());
+
+  // Trees sharing the pool exchange nodes without allocations
+  Target.merge(Shared);
+  EXPECT_EQ(200, Allocator.allocated());
+  EXPECT_EQ(Target.size() + Shared.size(), Allocator.allocated());
+
+  // Nodes of the other pool can't move, values are moved to the new ones
+  Target.merge(Separate);
+  EXPECT_EQ(Target.size() + Shared.size(), Allocator.allocated());
+  EXPECT_EQ(Separate.size(), Separate.get_allocator().allocated());
+
+  std::map<int, std::string> Standard;
+  for (const auto &[Factor, Value] :
+       {std::pair{3, "target"}, {2, "shared"}, {5, "separate"}}) {
+    for (int i = 0; i < 100; ++i) {
+      Standard.emplace(i * Factor, Value);
+    }
+  }
+  EXPECT_TRUE(std::equal(Standard.begin(), Standard.end(), Target.begin(),
+                         Target.end()));
+}